@@ -0,0 +1,471 @@
+/**
+ * @file flowshopbench.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Microbenchmark entry point, measures the flowshop evaluation
+ * kernels of every variant over a range of generated instance sizes.
+ * @version 0.1
+ * @date 2019-06-02
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "flowshopbasic.h"
+#include "flowshopblocking.h"
+#include "flowshopnowait.h"
+#include "flowshopsdst.h"
+#include "flowshopbuffered.h"
+#include "instancegen.h"
+#include "jsonl.h"
+#include "mem.h"
+#include "perfcounters.h"
+#include "alloctrack.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace fshop;
+
+/**
+ * @brief Instance size to benchmark
+ */
+struct BenchSize
+{
+    size_t jobs;
+    size_t machines;
+};
+
+/**
+ * @brief Timing summary of one kernel on one variant and instance size
+ */
+struct BenchResult
+{
+    size_t batch;       /** Evaluations per timed repetition */
+    double medianNs;    /** Median time per evaluation in nanoseconds */
+    double p95Ns;       /** 95th percentile time per evaluation in nanoseconds */
+    double minNs;       /** Fastest time per evaluation in nanoseconds */
+    double cellsPerSec; /** Processing time cells evaluated per second, at the median */
+    util::PerfSample perf; /** Hardware event counts over all timed repetitions */
+    util::AllocStats alloc; /** Heap allocations over all timed repetitions, in allocation tracking builds */
+};
+
+/**
+ * @brief Benchmark settings, given on the command line
+ */
+struct BenchParams
+{
+    string jsonFile;
+    int repetitions = 15;
+    int warmup = 3;
+    double minBatchMs = 2.0;
+    vector<BenchSize> sizes;
+    util::PerfCounters* perf = nullptr; /** Hardware counters, if requested with --perf */
+};
+
+// Written by every kernel, so evaluations cannot be optimized away
+static volatile long long sink = 0;
+
+/**
+ * @brief Allocates the flowshop variant with the given index
+ * 
+ * @param instance Instance to evaluate
+ * @param alg Index of the flowshop algorithm. 0 = Standard, 1 = With Blocking, 2 = With No Wait, 3 = With Setup Times,
+ * 4 = With Limited Buffers (of size 2).
+ * @param setups Setup times of the instance, only used by algorithm 3
+ * @return Returns the new flowshop object
+ */
+static FlowshopBasic* allocVariant(InstancePtr instance, int alg, SetupTimesPtr setups)
+{
+    if (alg == 1)
+        return new FlowshopBlocking(instance);
+    else if (alg == 2)
+        return new FlowshopNoWait(instance);
+    else if (alg == 3)
+        return new FlowshopSDST(instance, setups);
+    else if (alg == 4)
+        return new FlowshopBuffered(instance, { 2 });
+    else
+        return new FlowshopBasic(instance);
+}
+
+/**
+ * @brief Returns the short name of the flowshop variant with the given index
+ */
+static const char* variantName(int alg)
+{
+    if (alg == 1)
+        return "blocking";
+    else if (alg == 2)
+        return "nowait";
+    else if (alg == 3)
+        return "sdst";
+    else if (alg == 4)
+        return "buffered";
+    else
+        return "basic";
+}
+
+/**
+ * @brief Generates a uniform [1, 99] instance of the given size
+ * 
+ * @param size Number of jobs and machines
+ * @return Returns the generated instance
+ */
+static InstancePtr generateInstance(const BenchSize& size)
+{
+    InstanceGenerator gen(size.jobs, size.machines, 873654221);
+    auto data = make_shared<vector<int>>(size.jobs * size.machines);
+
+    for (size_t m = 0; m < size.machines; m++)
+        gen.nextRow(data->data() + m * size.jobs);
+
+    const string name = to_string(size.jobs) + "x" + to_string(size.machines);
+    return Instance::createView(data->data(), size.machines, size.jobs, name, data);
+}
+
+/**
+ * @brief Generates uniform [1, 49] setup times for an instance of the given size.
+ * Sizes whose setup times would exceed 256 MB are skipped.
+ * 
+ * @param size Number of jobs and machines
+ * @return Returns the generated setup times, or nullptr if the size is too large
+ */
+static SetupTimesPtr generateSetups(const BenchSize& size)
+{
+    if (SetupTimes::estimateBytes(size.machines, size.jobs) > 256u * 1024 * 1024)
+        return nullptr;
+
+    TaillardRandom rand(12345);
+    vector<int> blocks(size.machines * size.jobs * size.jobs);
+    for (size_t i = 0; i < blocks.size(); i++)
+        blocks[i] = rand.unif(1, 49);
+
+    const string name = to_string(size.jobs) + "x" + to_string(size.machines);
+    return SetupTimes::create(blocks, size.machines, size.jobs, name);
+}
+
+/**
+ * @brief Times a kernel. The batch size is first grown until one batch takes at
+ * least minBatchMs, then the warmup batches are run, followed by the timed batches.
+ * Hardware counters, if enabled, count the events of all timed batches together,
+ * and so do the allocation counters of allocation tracking builds.
+ * 
+ * @param params Benchmark settings
+ * @param cells Number of processing time cells in the instance
+ * @param kernel Runs the kernel the given number of times
+ * @return Returns the timing summary
+ */
+template <class Kernel>
+static BenchResult timeKernel(const BenchParams& params, size_t cells, Kernel kernel)
+{
+    BenchResult res = { };
+    res.batch = 1;
+
+    // Calibrate the batch size
+    for (;;)
+    {
+        auto t0 = steady_clock::now();
+        kernel(res.batch);
+        double ms = duration<double, milli>(steady_clock::now() - t0).count();
+
+        if (ms >= params.minBatchMs || res.batch >= (1u << 30)) break;
+        res.batch *= ms < params.minBatchMs / 8 ? 8 : 2;
+    }
+
+    for (int i = 0; i < params.warmup; i++)
+        kernel(res.batch);
+
+    vector<double> samples;
+    const util::AllocStats allocBefore = util::threadAllocStats();
+    if (params.perf != nullptr) params.perf->start();
+
+    for (int i = 0; i < params.repetitions; i++)
+    {
+        auto t0 = steady_clock::now();
+        kernel(res.batch);
+        double ns = duration<double, nano>(steady_clock::now() - t0).count();
+        samples.push_back(ns / res.batch);
+    }
+
+    if (params.perf != nullptr) res.perf = params.perf->stop();
+    res.alloc = util::threadAllocStats().since(allocBefore);
+
+    sort(samples.begin(), samples.end());
+
+    const size_t n = samples.size();
+    res.minNs = samples.front();
+    res.medianNs = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2.0;
+    res.p95Ns = samples[static_cast<size_t>(ceil(0.95 * n)) - 1];
+    res.cellsPerSec = cells / res.medianNs * 1e9;
+    return res;
+}
+
+/**
+ * @brief Parses a comma separated list of [jobs]x[machines] sizes
+ * 
+ * @param list Size list, such as "20x5,50x10"
+ * @param sizes Out vector that receives the sizes
+ * @return Returns true if every size is valid. Otherwise false.
+ */
+static bool parseSizes(const string& list, vector<BenchSize>& sizes)
+{
+    size_t start = 0;
+
+    while (start < list.size())
+    {
+        size_t end = list.find(',', start);
+        if (end == string::npos) end = list.size();
+
+        BenchSize size = { };
+        if (sscanf(list.substr(start, end - start).c_str(), "%zux%zu", &size.jobs, &size.machines) != 2
+            || size.jobs == 0 || size.machines == 0)
+            return false;
+
+        sizes.push_back(size);
+        start = end + 1;
+    }
+
+    return !sizes.empty();
+}
+
+/**
+ * @brief Returns the count of an event per evaluation as text, or "-" if the event was not counted
+ */
+static string perEvalText(const BenchResult& r, util::PerfEvent e, size_t evals)
+{
+    if (!r.perf.has(e)) return "-";
+
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.1f", static_cast<double>(r.perf.get(e)) / evals);
+    return buf;
+}
+
+/**
+ * @brief Program entry point. Usage:
+ * flowshop-bench [--perf] [json file|-] [repetitions] [warmup] [min batch ms] [sizes]
+ */
+int main(int argc, char** argv)
+{
+    BenchParams params;
+    util::PerfCounters perf;
+
+    // Hardware counters are opt-in, and the flag may appear anywhere
+    vector<char*> args;
+    for (int i = 0; i < argc; i++)
+    {
+        if (i > 0 && string(argv[i]) == "--perf")
+            params.perf = &perf;
+        else
+            args.push_back(argv[i]);
+    }
+
+    argc = static_cast<int>(args.size());
+    argv = args.data();
+
+    if (argc > 1 && string(argv[1]) != "-") params.jsonFile = argv[1];
+    if (argc > 2) params.repetitions = atoi(argv[2]);
+    if (argc > 3) params.warmup = atoi(argv[3]);
+    if (argc > 4) params.minBatchMs = atof(argv[4]);
+
+    if (argc > 5 && !parseSizes(argv[5], params.sizes))
+    {
+        cerr << "Error: Invalid size list, expected [jobs]x[machines],..." << endl;
+        return 1;
+    }
+
+    if (argc > 6 || params.repetitions < 1 || params.warmup < 0 || params.minBatchMs <= 0)
+    {
+        cerr << "Proper usage: " << argv[0] << " [--perf] [json file|-] [repetitions] [warmup] [min batch ms] [sizes]" << endl;
+        cerr << "Example: " << argv[0] << " bench.jsonl 15 3 2 20x5,50x10,500x20" << endl;
+        return 1;
+    }
+
+    // Taillard's benchmark sizes, plus a tiny and a few larger generated sizes
+    if (params.sizes.empty())
+    {
+        parseSizes("5x4,20x5,20x10,20x20,50x5,50x10,50x20,100x5,100x10,100x20,"
+                   "200x10,200x20,500x20,1000x20,1000x50,2000x50", params.sizes);
+    }
+
+    util::JsonlWriter json;
+    if (!params.jsonFile.empty() && !json.open(params.jsonFile.c_str()))
+    {
+        cerr << "Error: Unable to open output file: " << params.jsonFile << endl;
+        return 1;
+    }
+
+    if (params.perf != nullptr)
+    {
+        if (!perf.open())
+        {
+            cout << "Warning: Hardware performance counters are unavailable (" << perf.getError() << ")." << endl;
+            params.perf = nullptr;
+        }
+        else if (!perf.getError().empty())
+        {
+            cout << "Warning: Some hardware performance counters are unavailable (" << perf.getError() << ")." << endl;
+        }
+    }
+
+    cout << left << setw(10) << "variant" << setw(14) << "kernel" << setw(11) << "size"
+         << right << setw(14) << "median ns" << setw(14) << "p95 ns" << setw(16) << "Mcells/s";
+
+    if (params.perf != nullptr)
+        cout << setw(12) << "cyc/eval" << setw(8) << "IPC" << setw(12) << "L1D/eval" << setw(12) << "LLC/eval" << setw(12) << "brmis/eval";
+
+    if (util::allocTrackingEnabled())
+        cout << setw(13) << "allocs/eval" << setw(13) << "bytes/eval";
+
+    cout << endl;
+
+    for (auto& size : params.sizes)
+    {
+        InstancePtr instance = generateInstance(size);
+        SetupTimesPtr setups = generateSetups(size);
+        const size_t cells = size.jobs * size.machines;
+
+        // Evaluate one fixed random permutation of the 1-based job numbers
+        vector<int> seq(size.jobs);
+        iota(seq.begin(), seq.end(), 1);
+        shuffle(seq.begin(), seq.end(), mt19937(12345));
+
+        int** startTimes = util::allocMatrix<int>(size.machines, size.jobs);
+        int** departTimes = util::allocMatrix<int>(size.machines, size.jobs);
+
+        for (int alg = 0; alg <= 4; alg++)
+        {
+            if (alg == 3 && setups == nullptr)
+                continue;
+
+            unique_ptr<FlowshopBasic> fs(allocVariant(instance, alg, setups));
+            FlowshopBasic* f = fs.get();
+            int* s = seq.data();
+            const size_t n = seq.size();
+
+            vector<pair<const char*, BenchResult>> results;
+
+            results.emplace_back("evaluate", timeKernel(params, cells, [=](size_t batch) {
+                for (size_t i = 0; i < batch; i++)
+                    sink += f->evaluate(s, n).cmax;
+            }));
+
+            results.emplace_back("calcObjective", timeKernel(params, cells, [=](size_t batch) {
+                for (size_t i = 0; i < batch; i++)
+                    sink += f->calcObjective(s, n)->cmax;
+            }));
+
+            results.emplace_back("timeMatrices", timeKernel(params, cells, [=](size_t batch) {
+                for (size_t i = 0; i < batch; i++)
+                {
+                    f->calcTimeMatrices(s, n, startTimes, departTimes);
+                    sink += departTimes[size.machines - 1][n - 1];
+                }
+            }));
+
+            for (auto& r : results)
+            {
+                const string sizeName = to_string(size.jobs) + "x" + to_string(size.machines);
+
+                cout << left << setw(10) << variantName(alg) << setw(14) << r.first << setw(11) << sizeName
+                     << right << fixed << setprecision(1) << setw(14) << r.second.medianNs << setw(14) << r.second.p95Ns
+                     << setw(16) << r.second.cellsPerSec / 1e6;
+
+                const size_t evals = r.second.batch * params.repetitions;
+                const util::PerfSample& ps = r.second.perf;
+
+                if (params.perf != nullptr)
+                {
+                    string ipc = "-";
+                    if (ps.has(util::PERF_CYCLES) && ps.has(util::PERF_INSTRUCTIONS) && ps.get(util::PERF_CYCLES) > 0)
+                    {
+                        char buf[32];
+                        snprintf(buf, sizeof(buf), "%.2f", static_cast<double>(ps.get(util::PERF_INSTRUCTIONS)) / ps.get(util::PERF_CYCLES));
+                        ipc = buf;
+                    }
+
+                    cout << setw(12) << perEvalText(r.second, util::PERF_CYCLES, evals) << setw(8) << ipc
+                         << setw(12) << perEvalText(r.second, util::PERF_L1D_MISSES, evals)
+                         << setw(12) << perEvalText(r.second, util::PERF_LLC_MISSES, evals)
+                         << setw(12) << perEvalText(r.second, util::PERF_BRANCH_MISSES, evals);
+                }
+
+                if (util::allocTrackingEnabled())
+                {
+                    cout << setprecision(2) << setw(13) << static_cast<double>(r.second.alloc.allocs) / evals
+                         << setw(13) << static_cast<double>(r.second.alloc.bytes) / evals << setprecision(1);
+                }
+
+                cout << endl;
+
+                if (!params.jsonFile.empty())
+                {
+                    util::JsonRecord rec;
+                    rec.field("variant", variantName(alg))
+                       .field("kernel", r.first)
+                       .field("jobs", size.jobs)
+                       .field("machines", size.machines)
+                       .field("repetitions", params.repetitions)
+                       .field("batch", r.second.batch)
+                       .field("nsPerEvalMedian", r.second.medianNs)
+                       .field("nsPerEvalP95", r.second.p95Ns)
+                       .field("nsPerEvalMin", r.second.minNs)
+                       .field("cellsPerSec", r.second.cellsPerSec);
+
+                    if (util::allocTrackingEnabled())
+                    {
+                        rec.field("allocsPerEval", static_cast<double>(r.second.alloc.allocs) / evals)
+                           .field("allocBytesPerEval", static_cast<double>(r.second.alloc.bytes) / evals);
+                    }
+
+                    // Hardware event counts per evaluation
+                    if (params.perf != nullptr)
+                    {
+                        rec.beginObject("perfPerEval");
+                        for (int e = 0; e < util::PERF_EVENT_COUNT; e++)
+                        {
+                            const util::PerfEvent ev = static_cast<util::PerfEvent>(e);
+                            if (ps.has(ev))
+                                rec.field(util::PerfCounters::eventName(ev), static_cast<double>(ps.get(ev)) / evals);
+                            else
+                                rec.field(util::PerfCounters::eventName(ev), nullptr);
+                        }
+                        rec.endObject();
+                    }
+
+                    json.write(rec);
+                }
+            }
+        }
+
+        util::releaseMatrix(startTimes, size.machines);
+        util::releaseMatrix(departTimes, size.machines);
+    }
+
+    if (!params.jsonFile.empty())
+    {
+        if (!json.close())
+        {
+            cerr << "Error: Unable to write output file: " << params.jsonFile << endl;
+            return 1;
+        }
+
+        cout << "Results written to: " << params.jsonFile << endl;
+    }
+
+    return 0;
+}
+
+// =========================
+// End of flowshopbench.cpp
+// =========================
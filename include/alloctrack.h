@@ -0,0 +1,47 @@
+/**
+ * @file alloctrack.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the allocation tracking functions, which count the heap
+ * allocations of each thread when built with FSHOP_ALLOC_TRACKING.
+ * @version 0.1
+ * @date 2019-06-02
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __ALLOCTRACK_H
+#define __ALLOCTRACK_H
+
+#include <cstdint>
+
+namespace util
+{
+    /**
+     * @brief Heap allocation counts of a thread. Counts only grow, except
+     * liveBytes, which is the bytes allocated minus the bytes freed. Memory
+     * freed by a different thread than the one that allocated it lowers the
+     * live bytes of the freeing thread, so liveBytes may be negative.
+     */
+    struct AllocStats
+    {
+        uint64_t allocs;        /** Number of allocations */
+        uint64_t frees;         /** Number of frees */
+        uint64_t bytes;         /** Total bytes allocated */
+        uint64_t bytesFreed;    /** Total bytes freed */
+        int64_t liveBytes;      /** Bytes allocated and not yet freed */
+        int64_t peakLiveBytes;  /** Highest liveBytes since the last resetThreadAllocPeak() */
+
+        AllocStats since(const AllocStats& earlier) const;
+    };
+
+    bool allocTrackingEnabled();
+    AllocStats threadAllocStats();
+    void resetThreadAllocPeak();
+}
+
+#endif
+
+// =========================
+// End of alloctrack.h
+// =========================
@@ -0,0 +1,83 @@
+/**
+ * @file canceltoken.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the CancelToken class, a thread-safe flag used to
+ * cooperatively cancel a batch of running and queued tasks.
+ * @version 0.1
+ * @date 2019-05-28
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __CANCELTOKEN_H
+#define __CANCELTOKEN_H
+
+#include <atomic>
+
+namespace util
+{
+    /**
+     * @brief The CancelToken class is a flag shared by all tasks of a batch.
+     * Any thread may request cancellation, and long running tasks poll
+     * isCancelled() at convenient points and stop early when it is set.
+     * 
+     * --
+     * Request cancellation:
+     * 
+     * token.cancel();
+     * 
+     * --
+     * Check for cancellation within a task:
+     * 
+     * if (token.isCancelled()) return;
+     */
+    class CancelToken
+    {
+    public:
+        /**
+         * @brief Construct a new CancelToken object in the non-cancelled state
+         */
+        CancelToken() : cancelled(false)
+        {
+        }
+
+        /**
+         * @brief Requests cancellation of all tasks sharing this token
+         */
+        void cancel()
+        {
+            cancelled.store(true, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Clears a previous cancellation request
+         */
+        void reset()
+        {
+            cancelled.store(false, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Returns true if cancellation has been requested
+         */
+        bool isCancelled() const
+        {
+            return cancelled.load(std::memory_order_relaxed);
+        }
+
+        // Delete copy/move constructors and assignments
+        CancelToken(const CancelToken& o) = delete;
+        CancelToken(CancelToken&& o) = delete;
+        CancelToken& operator=(const CancelToken& o) = delete;
+        CancelToken& operator=(CancelToken&& o) = delete;
+    private:
+        std::atomic<bool> cancelled; /** Set once cancellation has been requested */
+    };
+}
+
+#endif
+
+// =========================
+// End of canceltoken.h
+// =========================
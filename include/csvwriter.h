@@ -0,0 +1,101 @@
+/**
+ * @file csvwriter.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the CsvWriter class, a buffered writer for
+ * streaming rows of values to a *.csv file.
+ * @version 0.1
+ * @date 2019-05-29
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __CSVWRITER_H
+#define __CSVWRITER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+namespace util
+{
+    /**
+     * @brief Controls when written data is forced to stable storage with fsync
+     */
+    enum FsyncPolicy
+    {
+        FSYNC_NONE = 0,     /** Never fsync, leave it to the operating system */
+        FSYNC_ON_CLOSE = 1, /** Fsync once when the file is closed */
+        FSYNC_ON_FLUSH = 2  /** Fsync every time the buffer is written out */
+    };
+
+    FsyncPolicy parseFsyncPolicy(const std::string& name);
+
+    /**
+     * @brief The CsvWriter class streams comma separated values to a file through
+     * a large write buffer. Numbers are formatted without iostreams or locales,
+     * and data is only forced to disk as the fsync policy requires.
+     * 
+     * --
+     * Write a file with a header row and one data row:
+     * 
+     * CsvWriter csv;
+     * csv.open("my_file.csv");
+     * csv.field("Name").field("Value").endRow();
+     * csv.field("cmax").field(1289).endRow();
+     * bool success = csv.close();
+     */
+    class CsvWriter
+    {
+    public:
+        explicit CsvWriter(size_t _bufferSize = 1024 * 1024);
+        ~CsvWriter();
+
+        bool open(const char* filePath, FsyncPolicy _policy = FSYNC_NONE, bool append = false);
+        bool flush();
+        bool close();
+        bool good() const;
+
+        CsvWriter& field(long long val);
+        CsvWriter& field(unsigned long long val);
+        CsvWriter& field(int val);
+        CsvWriter& field(unsigned int val);
+        CsvWriter& field(long val);
+        CsvWriter& field(unsigned long val);
+        CsvWriter& field(double val);
+        CsvWriter& field(const char* val);
+        CsvWriter& field(const std::string& val);
+        CsvWriter& endRow();
+        CsvWriter& raw(const void* data, size_t size);
+
+        void setPrecision(int _precision);
+        void setDelimiter(char _delimiter);
+
+        // Delete copy/move constructors and assignments
+        CsvWriter(const CsvWriter& o) = delete;
+        CsvWriter(CsvWriter&& o) = delete;
+        CsvWriter& operator=(const CsvWriter& o) = delete;
+        CsvWriter& operator=(CsvWriter&& o) = delete;
+    private:
+        FILE* file; /** Output file handle */
+        char* buffer; /** Write buffer */
+        size_t bufferSize; /** Capacity of the write buffer */
+        size_t used; /** Number of bytes currently in the write buffer */
+        bool rowStart; /** True if the next field is the first of its row */
+        bool error; /** True if any write has failed */
+        int precision; /** Significant digits used for floating point values */
+        char delimiter; /** Character written between fields */
+        FsyncPolicy policy; /** When to force data to disk */
+
+        void separator();
+        void write(const char* data, size_t size);
+        bool writeBuffer();
+        bool syncFile();
+    };
+}
+
+#endif
+
+// =========================
+// End of csvwriter.h
+// =========================
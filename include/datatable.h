@@ -18,6 +18,7 @@
 #include <stdexcept>
 #include <iomanip>
 #include "mem.h"
+#include "csvwriter.h"
 
 namespace mdata
 {
@@ -154,40 +155,33 @@ namespace mdata
          * @brief Exports the contents of this DataTable to a .csv file
          * 
          * @param filePath Path to the file that will be filled with this table's values
+         * @param policy When the written data is forced to disk
          * @return true If the file was successfully written to
-         * @return false If there was an error opening the file
+         * @return false If there was an error opening or writing the file
          */
-        bool exportCSV(const char* filePath)
+        bool exportCSV(const char* filePath, util::FsyncPolicy policy = util::FSYNC_NONE)
         {
             if (dataMatrix == nullptr) return false;
 
-            using namespace std;
-            ofstream outFile;
-            outFile.open(filePath, ofstream::out | ofstream::trunc);
-            if (!outFile.good()) return false;
+            util::CsvWriter csv;
+            if (!csv.open(filePath, policy)) return false;
 
             // Print column labels
-            for (unsigned int c = 0; c < cols; c++)
-            {
-                outFile << colLabels[c];
-                if (c < cols - 1) outFile << ",";
-            }
+            for (size_t c = 0; c < cols; c++)
+                csv.field(colLabels[c]);
 
-            outFile << endl;
+            csv.endRow();
 
             // Print data rows
-            for (unsigned int r = 0; r < rows; r++)
+            for (size_t r = 0; r < rows; r++)
             {
-                for (unsigned int c = 0; c < cols; c++)
-                {
-                    outFile << std::setprecision(8) << dataMatrix[r][c];
-                    if (c < cols - 1) outFile << ",";
-                }
-                outFile << endl;
+                for (size_t c = 0; c < cols; c++)
+                    csv.field(dataMatrix[r][c]);
+
+                csv.endRow();
             }
 
-            outFile.close();
-            return true;
+            return csv.close();
         }
     private:
         size_t rows; /** Number of rows in the table. */
@@ -0,0 +1,75 @@
+/**
+ * @file duedates.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the DueDates class, which holds the due date and
+ * weight of every job of a flowshop problem.
+ * @version 0.1
+ * @date 2019-06-07
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __DUEDATES_H
+#define __DUEDATES_H
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fshop
+{
+    class DueDates;
+
+    using DueDatesPtr = std::shared_ptr<const DueDates>;
+
+    /**
+     * @brief The DueDates class stores the due date and tardiness weight of
+     * every job. Like Instance, due dates are immutable once loaded and can
+     * be shared between threads and flowshop variants.
+     * 
+     * Due dates are a section of a text file, either at the end of a data set
+     * file (after any setup times) or alone in a sidecar file. The section is a
+     * line holding "due" followed by a line of n due dates, and optionally a
+     * line holding "weights" followed by a line of n weights. Weights default to 1.
+     * 
+     * --
+     * Due dates of a 3 job data set, where the second job counts twice:
+     * 
+     * due
+     * 120 150 90
+     * weights
+     * 1 2 1
+     */
+    class DueDates
+    {
+    public:
+        static DueDatesPtr loadFromFile(const char* filePath);
+        static DueDatesPtr create(const std::vector<int>& _dueDates, const std::vector<int>& _weights, const std::string& name);
+        ~DueDates() = default;
+
+        size_t getTotalJobs() const;
+        const int* getDueDates() const;
+        const int* getWeights() const;
+        const std::string& getFilePath() const;
+
+        // Delete copy/move constructors and assignments
+        DueDates(const DueDates& o) = delete;
+        DueDates(DueDates&& o) = delete;
+        DueDates& operator=(const DueDates& o) = delete;
+        DueDates& operator=(DueDates&& o) = delete;
+    private:
+        DueDates(const std::vector<int>& _dueDates, const std::vector<int>& _weights, const std::string& _filePath);
+
+        std::vector<int> dueDates; /** Due date of each job, indexed [job] */
+        std::vector<int> weights; /** Tardiness weight of each job, indexed [job] */
+        std::string filePath; /** Path of the file the due dates were loaded from */
+    };
+}
+
+#endif
+
+// =========================
+// End of duedates.h
+// =========================
@@ -13,9 +13,25 @@
 #define __EXPERIMENT_H
 
 #include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
 #include "inireader.h"
 #include "datatable.h"
+#include "instance.h"
+#include "instancepack.h"
+#include "canceltoken.h"
 #include "flowshopbasic.h"
+#include "setuptimes.h"
+#include "timesfile.h"
+#include "jsonl.h"
+#include "journal.h"
+#include "timing.h"
+#include "verify.h"
+#include "membudget.h"
+
+class ThreadPool;
 
 namespace cs471
 {
@@ -25,19 +41,67 @@ namespace cs471
      */
     struct TestParams
     {
+        std::string name;
         int minTestFile;
         int maxTestFile;
         int numThreads;
         int algorithm;
         std::string inputFilesDir;
+        std::string setupTimesDir;
+        std::string dueDatesDir;
+        fshop::ObjectiveType objective;
+        std::vector<int> bufferSizes;
         std::string resultsFile;
         std::string timesFile;
+        fshop::TimesFormat timesFormat;
+        bool timesCompress;
+        std::string ganttDir;
+        std::string jsonlFile;
+        std::string journalFile;
+        bool resume;
+        bool perfCounters;
+        util::FsyncPolicy fsyncPolicy;
+        unsigned int seed;
+        std::string goldenFile;
+        std::string baselineFile;
+        VerifyParams verify;
+    };
+
+    /**
+     * @brief Return codes of a single threaded NEH task
+     */
+    enum TaskResult
+    {
+        TASK_OK = 0,           /** NEH completed and results were recorded */
+        TASK_LOAD_ERROR = 1,   /** The input file could not be loaded */
+        TASK_NEH_ERROR = 2,    /** An exception occurred while running NEH */
+        TASK_SKIPPED = -1      /** The batch was cancelled before the task finished */
+    };
+
+    /**
+     * @brief Input file shared by every flowshop variant scheduled on it.
+     * The first task to run loads the instance, either from a text file
+     * or from an instance pack, and the last task to finish releases it.
+     */
+    struct SharedInstance
+    {
+        std::string inputFile;
+        int testIndex = 0;
+        std::shared_ptr<fshop::InstancePack> pack;
+        int pendingTasks = 0;
+        bool loadFailed = false;
+        fshop::InstancePtr instance;
+        size_t machines = 0;         /** Matrix size from the file header, zero if unknown */
+        size_t jobs = 0;
+        util::SharedReservation instanceBytes; /** Estimated memory of the loaded instance, held in the memory budget by its tasks */
+        std::mutex lock;
     };
 
     /**
      * @brief The experiment class runs takes a given ini file path,
      * opens it, parses the parameters, then runs the NEH algorithm
-     * with the given parameters.
+     * with the given parameters. Each [test.*] section in the ini file
+     * adds a flowshop variant, and all variants share one thread pool.
      */
     class Experiment
     {
@@ -46,13 +110,33 @@ namespace cs471
         ~Experiment() = default;
 
         int runNEH();
+        int runVerify();
+        int runScaling(const std::vector<int>& threadCounts, int repetitions, const std::string& reportPrefix);
         int runDebugSeq(int* seq, size_t seqSize);
     private:
         util::IniReader iniParams;
+        util::CancelToken cancelToken; /** Cancels all remaining tasks once any task fails */
+        std::map<std::string, std::unique_ptr<util::JsonlWriter>> jsonlWriters; /** Open JSON-lines results streams, by file path */
+        std::map<std::string, std::unique_ptr<util::Journal>> journals; /** Open checkpoint journals, by file path */
+        std::map<std::thread::id, util::PhaseTotals> threadPhases; /** Phase times of the current batch, by thread */
+        std::mutex threadPhasesLock; /** Guards threadPhases */
+        util::MemoryBudget memoryBudget; /** Limits the estimated memory of running tasks */
 
-        int runNEHThreaded(TestParams* const p, const std::string inputFile, int testIndex, mdata::DataTable<std::string>* resultsTable);
-        fshop::FlowshopBasic* allocFlowShop(const char* inputFile, int alg);
-        TestParams readTestParams();
+        int runBatch(std::vector<TestParams>& variants, std::vector<std::unique_ptr<mdata::DataTable<std::string>>>& resultsTables);
+        int runNEHThreaded(TestParams* const p, SharedInstance* shared, int testIndex, mdata::DataTable<std::string>* resultsTable, ThreadPool* outputPool);
+        void outputSolution(const TestParams* p, int testIndex, std::shared_ptr<fshop::FlowshopSolution> solution, mdata::DataTable<std::string>* resultsTable, std::vector<std::string> row, size_t outputBytes);
+        static void writeSolutionFiles(const TestParams* p, int testIndex, fshop::FlowshopSolution& solution);
+        void journalResult(const TestParams* p, int testIndex, const std::vector<std::string>& row);
+        void recordThreadPhases(const util::PhaseTotals& phases);
+        void printThreadPhases();
+        void writeTrace(const std::string& traceFile);
+        void printMemorySummary();
+        fshop::InstancePtr acquireInstance(SharedInstance* shared);
+        void releaseInstance(SharedInstance* shared);
+        bool admitTask(SharedInstance* shared, size_t taskBytes, double& waitMs);
+        fshop::FlowshopBasic* allocFlowShop(fshop::InstancePtr instance, int alg, fshop::SetupTimesPtr setups = nullptr, const std::vector<int>& bufferSizes = {});
+        std::vector<TestParams> readAllTestParams();
+        TestParams readTestParams(const std::string& section = "test");
     };
 }
 
@@ -0,0 +1,69 @@
+/**
+ * @file fileview.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the FileView class, which gives read-only access
+ * to the full contents of a file through a single memory region.
+ * @version 0.1
+ * @date 2019-05-28
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __FILEVIEW_H
+#define __FILEVIEW_H
+
+#include <cstddef>
+#include <vector>
+
+namespace util
+{
+    /**
+     * @brief The FileView class exposes the contents of a file as one
+     * contiguous, read-only block of memory. Regular files are memory-mapped
+     * where the platform supports it. Pipes, character devices and stdin
+     * (file path "-") are read into an internal buffer instead.
+     * 
+     * --
+     * Open a file and access its contents:
+     * 
+     * FileView view;
+     * if (view.open("my_file.txt"))
+     *     parse(view.data(), view.data() + view.size());
+     * 
+     * Note that the data is not null terminated.
+     */
+    class FileView
+    {
+    public:
+        FileView();
+        ~FileView();
+
+        bool open(const char* filePath);
+        void close();
+
+        const char* data() const;
+        size_t size() const;
+        bool isMapped() const;
+
+        // Delete copy/move constructors and assignments
+        FileView(const FileView& o) = delete;
+        FileView(FileView&& o) = delete;
+        FileView& operator=(const FileView& o) = delete;
+        FileView& operator=(FileView&& o) = delete;
+    private:
+        const char* viewData; /** Pointer to the start of the file contents */
+        size_t viewSize; /** Size of the file contents in bytes */
+        bool mapped; /** True if viewData points to a memory mapping */
+        std::vector<char> buffer; /** Holds the file contents when it could not be mapped */
+
+        bool readStream(int fd);
+        bool readFile(const char* filePath);
+    };
+}
+
+#endif
+
+// =========================
+// End of fileview.h
+// =========================
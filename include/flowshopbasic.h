@@ -20,39 +20,95 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <vector>
+#include "instance.h"
+#include "duedates.h"
+#include "csvwriter.h"
 
 namespace fshop
 {
+    class FlowshopBasic;
+
+    /**
+     * @brief Objectives that NEH can minimize
+     */
+    enum ObjectiveType
+    {
+        OBJ_CMAX = 0,               /** Departure time of the last job */
+        OBJ_TOTAL_TARDINESS = 1,    /** Sum of how late every job is past its due date */
+        OBJ_WEIGHTED_TARDINESS = 2, /** Sum of the tardiness of every job times its weight */
+        OBJ_MAX_LATENESS = 3        /** Largest departure time minus due date, may be negative */
+    };
+
+    bool parseObjectiveType(const std::string& name, ObjectiveType& out);
+    const char* objectiveTypeName(ObjectiveType type);
+
+    /**
+     * @brief Objective values of a single job sequence. The due date objectives
+     * are only calculated by flowshops that have due dates, and are zero otherwise.
+     */
+    struct ObjectiveValue
+    {
+        int cmax; /** Departure time of the last job on the last machine */
+        int totalFlowTime; /** Sum of all departure times on the last machine */
+        long long totalTardiness; /** Sum of max(0, departure - due date) over all jobs */
+        long long weightedTardiness; /** Sum of weight * max(0, departure - due date) over all jobs */
+        int maxLateness; /** Largest departure - due date over all jobs */
+
+        /**
+         * @brief Returns the value of the given objective
+         */
+        long long get(ObjectiveType type) const
+        {
+            switch (type)
+            {
+                case OBJ_TOTAL_TARDINESS: return totalTardiness;
+                case OBJ_WEIGHTED_TARDINESS: return weightedTardiness;
+                case OBJ_MAX_LATENESS: return maxLateness;
+                default: return cmax;
+            }
+        }
+    };
+
     /**
      * @brief The FlowshopSolution struct houses all solution data returned
      * from calculating the objective flowshop function. This includes the
      * cmax value, total flow time, job sequence used, start time matrix,
      * and departure time matrix.
+     * 
+     * Only the job sequence and objective values are stored up front. The start
+     * and departure time matrices are calculated on first access, by the flowshop
+     * that produced the solution, and then shared by all copies of the solution.
+     * The first access must not happen on two threads at once.
      */
     struct FlowshopSolution
     {
-        FlowshopSolution(int** _startimeMatrix, int** _departTimeMatrix, size_t _tMatrixRows, int* _jobSeq, size_t _seqSize, int _cmax, int _totalFlowTime);
-        ~FlowshopSolution();
+        FlowshopSolution(std::shared_ptr<const FlowshopBasic> _evaluator, const int* _jobSeq, size_t _seqSize, const ObjectiveValue& _value);
+        ~FlowshopSolution() = default;
 
         const size_t seqSize; /** Number of jobs in job sequence */
         const size_t numMachines; /** Number of machines executing jobs */
         const int cmax; /** Flowshop cmax value, which is the departure time of the last job */
         const int totalFlowTime; /** Flowshop total flow time value, which is the sum of all departure times on the last machine */
+        const ObjectiveValue value; /** All objective values, including the due date objectives if the flowshop has due dates */
 
         const int* const getJobSeq();
         std::string getJobSeqAsString();
         const int** const getStartTimeMatrix();
         const int** const getDepartTimeMatrix();
+        bool hasTimeMatrices() const;
 
-        bool outputTimesCsv(const std::string& fileNamePrefix);
+        bool outputTimesCsv(const std::string& fileNamePrefix, util::FsyncPolicy policy = util::FSYNC_NONE);
+        bool outputTimesBin(const std::string& filePath, bool compress, util::FsyncPolicy policy = util::FSYNC_NONE);
+        bool outputGanttCsv(const std::string& filePath, util::FsyncPolicy policy = util::FSYNC_NONE);
 
         void outputAll(std::ostream& os);
 
-        // Copy constructor
-        FlowshopSolution(const FlowshopSolution& obj);
+        // Copy constructor, shares the time matrices if they have been calculated
+        FlowshopSolution(const FlowshopSolution& obj) = default;
 
         // Move constructor
-        FlowshopSolution(FlowshopSolution&& obj);
+        FlowshopSolution(FlowshopSolution&& obj) = default;
 
         // Delete copy assignment
         FlowshopSolution& operator=(const FlowshopSolution& obj) = delete;
@@ -60,28 +116,45 @@ namespace fshop
         // Delete move assignment
         FlowshopSolution& operator=(FlowshopSolution&& obj) = delete;
     private:
-        int* jobSequence; /** Pointer to the job sequence array */
-        int** startTimeMatrix; /** Pointer to the start times matrix */
-        int** departTimeMatrix; /** Pointer to the departure times matrix */
+        struct TimeMatrices;
+
+        std::shared_ptr<const FlowshopBasic> evaluator; /** Flowshop that calculates the time matrices */
+        std::vector<int> jobSequence; /** The job sequence */
+        std::shared_ptr<const TimeMatrices> timeMatrices; /** Start and departure times, or nullptr until first accessed */
+
+        const TimeMatrices& getTimeMatrices();
     };
 
     /**
      * @brief The FlowshopBasic class runs the standard flowshop scheduling problem
-     * for a given job-machine processing time matrix that is read from a file. The run()
+     * for a given job-machine processing time matrix that is read from a file, or
+     * taken from an already loaded instance shared with other objects. The run()
      * method takes the specific job sequence being calculated. This class also serves as
      * a base class for the Flowshop with Blocking and Flowshop with No Wait problem variants.
+     * 
+     * Objective values are calculated one job (column) at a time, keeping only the
+     * previous column of departure times. Full start and departure time matrices are
+     * only built when a solution's matrices are accessed.
      */
     class FlowshopBasic
     {
     public:
         FlowshopBasic(const char* procTimeMatrixFile);
-        virtual ~FlowshopBasic();
+        FlowshopBasic(InstancePtr _instance);
+        virtual ~FlowshopBasic() = default;
         virtual std::unique_ptr<FlowshopSolution> calcObjective(int* seq, size_t seqSize);
+        virtual ObjectiveValue evaluate(const int* seq, size_t seqSize);
+        virtual std::unique_ptr<FlowshopSolution> makeSolution(const int* seq, size_t seqSize, const ObjectiveValue& value);
+        virtual void calcTimeMatrices(const int* seq, size_t seqSize, int** startTimeMatrix, int** departTimeMatrix) const;
 
         virtual int getProcessingTime(size_t machine, size_t job);
         virtual size_t getTotalJobs();
         virtual size_t getTotalMachines();
         virtual size_t getFuncCallCounts();
+        virtual InstancePtr getInstance() const;
+
+        void setDueDates(DueDatesPtr _dueDates);
+        DueDatesPtr getDueDates() const;
 
         // Delete copy/move constructors and assignments
         FlowshopBasic(const FlowshopBasic& o) = delete;
@@ -89,19 +162,50 @@ namespace fshop
         FlowshopBasic& operator=(const FlowshopBasic& o) = delete;
         FlowshopBasic& operator=(const FlowshopBasic&& o) = delete;
     protected:
-        int** procTimeMatrix;  /** The job processing time matrix, which is read from a file */
-        int** startTimeMatrix; /** The job start times matrix */
+        InstancePtr instance; /** The shared instance that holds the processing time matrix */
+        const int* const* procTimeMatrix;  /** The job processing time matrix, owned by the instance */
+        const int* const* jobTimeMatrix; /** The transposed processing time matrix [job][machine], owned by the instance */
         size_t ptMatrixRows; /** The number of rows (machines) in the processing time matrix */
         size_t ptMatrixCols; /** The number of columns (jobs) in the processing time matrix */
         size_t funcCallCounter; /** Keeps track of the number of times run() is called */
-
-        virtual void validateParams(int* seq, size_t seqSize);
-        virtual int** allocTimeMatrix(size_t rows, size_t cols);
-        virtual void initTimeMatrix(int** compTimeMatrix, int* seq, size_t rows, size_t cols);
-        virtual void calcTimeMatrix(int** compTimeMatrix, int* seq, size_t rows, size_t cols);
-        virtual void calcStartTimeCol(int** startTimeMatrix, int** departTimeMatrix, int* seq, size_t curCol, size_t rows, size_t cols);
-        virtual int getCmax(int** compTimeMatrix, size_t rows, size_t cols);
-        virtual int getTFT(int** compTimeMatrix, size_t rows, size_t cols);
+        std::vector<int> scratch; /** Column buffers used by evaluate() */
+        std::shared_ptr<const FlowshopBasic> sharedEvaluator; /** Copy of this flowshop shared by returned solutions */
+        DueDatesPtr dueDates; /** Due dates and weights of the jobs, or nullptr if there are none */
+        const int* jobDueDates; /** Due date of each job, owned by dueDates, or nullptr */
+        const int* jobWeights; /** Weight of each job, owned by dueDates, or nullptr */
+
+        virtual FlowshopBasic* clone() const;
+        virtual size_t getScratchSize() const;
+        virtual void validateParams(const int* seq, size_t seqSize);
+        virtual ObjectiveValue calcTimes(const int* seq, size_t seqSize, int* colBuffer, int** startTimeMatrix, int** departTimeMatrix) const;
+        virtual void calcDepartCol(const int* prevDepart, int* curDepart, const int* seq, size_t col) const;
+
+        ObjectiveValue initialValue() const;
+
+        /**
+         * @brief Adds a job's departure time from the last machine to the objective values.
+         * The due date objectives are updated one job at a time, without a second pass.
+         * 
+         * @param value Objective values of the sequence so far
+         * @param job Number of the job [1-n]
+         * @param completion Departure time of the job from the last machine
+         */
+        void addCompletion(ObjectiveValue& value, int job, int completion) const
+        {
+            value.totalFlowTime += completion;
+
+            if (jobDueDates != nullptr)
+            {
+                const int lateness = completion - jobDueDates[job - 1];
+                if (lateness > value.maxLateness) value.maxLateness = lateness;
+
+                if (lateness > 0)
+                {
+                    value.totalTardiness += lateness;
+                    value.weightedTardiness += static_cast<long long>(lateness) * jobWeights[job - 1];
+                }
+            }
+        }
     };
 }
 
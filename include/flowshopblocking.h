@@ -20,17 +20,18 @@ namespace fshop
 {
     /**
      * @brief The FlowshopBlocking class runs the flowshop with blocking problem
-     * for a given job-machine processing time matrix that is read from a file. The run()
+     * for a given job-machine processing time matrix that is read from a file or shared instance. The run()
      * method takes the specific job sequence being calculated. Inherits from FlowshopBasic.
      */
     class FlowshopBlocking : public fshop::FlowshopBasic
     {
     public:
         FlowshopBlocking(const char* procTimeMatrixFile);
+        FlowshopBlocking(InstancePtr _instance);
         virtual ~FlowshopBlocking() = default;
     protected:
-        virtual void initTimeMatrix(int** compTimeMatrix, int* seq, size_t rows, size_t cols) override;
-        virtual void calcTimeMatrix(int** compTimeMatrix, int* seq, size_t rows, size_t cols) override;
+        virtual FlowshopBasic* clone() const override;
+        virtual void calcDepartCol(const int* prevDepart, int* curDepart, const int* seq, size_t col) const override;
     };
 }
 
@@ -0,0 +1,70 @@
+/**
+ * @file flowshopbuffered.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the FlowshopBuffered class, which inherits
+ * FlowshopBasic and solves a flowshop with limited intermediate
+ * buffers for a specific job sequence.
+ * @version 0.1
+ * @date 2019-06-08
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __FLOWSHOPBUFFERED_H
+#define __FLOWSHOPBUFFERED_H
+
+#include <string>
+#include <vector>
+#include "flowshopbasic.h"
+
+namespace fshop
+{
+    /**
+     * @brief The FlowshopBuffered class runs the flowshop problem with limited buffers
+     * for a given job-machine processing time matrix. Between each pair of consecutive
+     * machines is a buffer that holds up to b jobs which have left the first machine
+     * but not yet started on the second. A finished job that finds the buffer full
+     * blocks its machine until a place frees up. Buffers of size 0 give the results
+     * of FlowshopBlocking, and unlimited buffers those of FlowshopBasic.
+     * 
+     * A job can only leave machine k once the job b + 1 places before it has left
+     * machine k + 1, so evaluation keeps a ring of the last b + 1 departure columns
+     * instead of full time matrices, O(b * m) ints for the largest buffer size b.
+     * Unlimited buffers, and buffers that can hold every remaining job, never block.
+     * Like FlowshopBlocking, start times in the time matrices are the departure times
+     * minus the processing times.
+     * 
+     * Buffer sizes are a section of the data set file: a line holding "buffers"
+     * followed by a line with either one size for every buffer or m - 1 sizes,
+     * one per pair of machines. A size of -1 is an unlimited buffer.
+     */
+    class FlowshopBuffered : public fshop::FlowshopBasic
+    {
+    public:
+        static const int UNLIMITED = -1; /** Buffer size of a buffer without limit */
+
+        FlowshopBuffered(const char* procTimeMatrixFile);
+        FlowshopBuffered(InstancePtr _instance, const std::vector<int>& _bufferSizes);
+        virtual ~FlowshopBuffered() = default;
+
+        const std::vector<int>& getBufferSizes() const;
+
+        static std::vector<int> loadBufferSizes(const char* filePath);
+        static bool parseBufferSizes(const std::string& text, std::vector<int>& out);
+    protected:
+        std::vector<int> bufferSizes; /** Size of the buffer after each machine, m - 1 entries */
+        size_t ringColumns; /** Number of departure columns kept while evaluating, the largest b + 1 but at least 2 */
+        std::vector<int> lagIndex; /** For each ring column and buffer, where in the ring the blocking departure is */
+
+        virtual FlowshopBasic* clone() const override;
+        virtual size_t getScratchSize() const override;
+        virtual ObjectiveValue calcTimes(const int* seq, size_t seqSize, int* colBuffer, int** startTimeMatrix, int** departTimeMatrix) const override;
+    };
+}
+
+#endif
+
+// =========================
+// End of flowshopbuffered.h
+// =========================
@@ -19,17 +19,18 @@ namespace fshop
 {
     /**
      * @brief The FlowshopNoWait class runs the flowshop with no wait problem
-     * for a given job-machine processing time matrix that is read from a file. The run()
+     * for a given job-machine processing time matrix that is read from a file or shared instance. The run()
      * method takes the specific job sequence being calculated. Inherits from FlowshopBasic.
      */
     class FlowshopNoWait : public fshop::FlowshopBasic
     {
     public:
         FlowshopNoWait(const char* procTimeMatrixFile);
+        FlowshopNoWait(InstancePtr _instance);
         virtual ~FlowshopNoWait() = default;
     protected:
-        virtual void initTimeMatrix(int** departTimeMatrix, int* seq, size_t rows, size_t cols) override;
-        virtual void calcTimeMatrix(int** departTimeMatrix, int* seq, size_t rows, size_t cols) override;
+        virtual FlowshopBasic* clone() const override;
+        virtual void calcDepartCol(const int* prevDepart, int* curDepart, const int* seq, size_t col) const override;
     };
 }
 
@@ -0,0 +1,50 @@
+/**
+ * @file flowshopsdst.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the FlowshopSDST class, which inherits
+ * FlowshopBasic and solves a flowshop with sequence-dependent
+ * setup times for a specific job sequence.
+ * @version 0.1
+ * @date 2019-06-06
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __FLOWSHOPSDST_H
+#define __FLOWSHOPSDST_H
+
+#include "flowshopbasic.h"
+#include "setuptimes.h"
+
+namespace fshop
+{
+    /**
+     * @brief The FlowshopSDST class runs the flowshop problem with sequence-dependent
+     * setup times for a given job-machine processing time matrix and setup time tensor.
+     * A machine starts the setup for the next job as soon as it is free, before the job
+     * has arrived, and the first job of the sequence gets its initial setup.
+     * Start times in the time matrices are the start of processing, after the setup.
+     * With all setup times zero, the results equal FlowshopBasic. Inherits from FlowshopBasic.
+     */
+    class FlowshopSDST : public fshop::FlowshopBasic
+    {
+    public:
+        FlowshopSDST(const char* procTimeMatrixFile);
+        FlowshopSDST(InstancePtr _instance, SetupTimesPtr _setupTimes);
+        virtual ~FlowshopSDST() = default;
+
+        SetupTimesPtr getSetupTimes() const;
+    protected:
+        SetupTimesPtr setupTimes; /** The shared setup time tensor */
+
+        virtual FlowshopBasic* clone() const override;
+        virtual void calcDepartCol(const int* prevDepart, int* curDepart, const int* seq, size_t col) const override;
+    };
+}
+
+#endif
+
+// =========================
+// End of flowshopsdst.h
+// =========================
@@ -16,6 +16,7 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <vector>
 #include <iostream>
 #include <fstream>
 
@@ -51,6 +52,7 @@ namespace util
         bool openFile(std::string filePath);
         bool sectionExists(std::string section);
         bool entryExists(std::string section, std::string entry);
+        std::vector<std::string> getSectionNames();
         std::string getEntry(std::string section, std::string entry, std::string defVal = "");
 
         template <class T>
@@ -0,0 +1,83 @@
+/**
+ * @file instance.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the Instance class, which holds the job processing
+ * time matrix for a single flowshop problem. Instances are immutable
+ * and can be shared read-only between several flowshop objective functions.
+ * @version 0.1
+ * @date 2019-05-28
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __INSTANCE_H
+#define __INSTANCE_H
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fshop
+{
+    class Instance;
+
+    using InstancePtr = std::shared_ptr<const Instance>;
+
+    /**
+     * @brief The Instance class stores the job-machine processing time matrix
+     * of a flowshop problem. Once loaded, an instance is never modified, which
+     * makes it safe to share between threads and flowshop variants via InstancePtr.
+     * An instance either owns its matrix, or is a zero-copy view into memory
+     * owned by another object, such as a memory-mapped instance pack.
+     * 
+     * Data derived from the matrix (per-job totals, per-machine totals and a
+     * job-major transposed copy) is computed once when the instance is created.
+     */
+    class Instance
+    {
+    public:
+        static InstancePtr loadFromFile(const char* procTimeMatrixFile);
+        static InstancePtr createView(const int* data, size_t rows, size_t cols, const std::string& name, std::shared_ptr<const void> storage);
+        static bool readFileHeader(const char* procTimeMatrixFile, size_t& rows, size_t& cols);
+        static size_t estimateBytes(size_t rows, size_t cols);
+        ~Instance();
+
+        size_t getTotalMachines() const;
+        size_t getTotalJobs() const;
+        const int* const* getProcTimeMatrix() const;
+        const int* const* getJobTimeMatrix() const;
+        const int* getJobTotals() const;
+        const int* getMachineTotals() const;
+        const std::string& getFilePath() const;
+
+        // Delete copy/move constructors and assignments
+        Instance(const Instance& o) = delete;
+        Instance(Instance&& o) = delete;
+        Instance& operator=(const Instance& o) = delete;
+        Instance& operator=(Instance&& o) = delete;
+    private:
+        Instance(int** _procTimeMatrix, size_t _rows, size_t _cols, const std::string& _filePath);
+        Instance(const int* data, size_t _rows, size_t _cols, const std::string& _filePath, std::shared_ptr<const void> _storage);
+
+        int** ownedMatrix; /** The job processing time matrix if owned by this instance, otherwise nullptr */
+        std::vector<const int*> rowPtrs; /** Pointers to each row (machine) of the processing time matrix */
+        std::shared_ptr<const void> storage; /** Keeps the memory of a view alive */
+        size_t ptMatrixRows; /** The number of rows (machines) in the processing time matrix */
+        size_t ptMatrixCols; /** The number of columns (jobs) in the processing time matrix */
+        std::string filePath; /** Path of the file the instance was loaded from */
+        std::vector<int> jobTimes; /** Transposed processing times, stored [job][machine] */
+        std::vector<const int*> jobPtrs; /** Pointers to each row (job) of the transposed matrix */
+        std::vector<int> jobTotals; /** Total processing time of each job over all machines */
+        std::vector<int> machineTotals; /** Total processing time of each machine over all jobs */
+
+        void precompute();
+    };
+}
+
+#endif
+
+// =========================
+// End of instance.h
+// =========================
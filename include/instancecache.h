@@ -0,0 +1,117 @@
+/**
+ * @file instancecache.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the InstanceCache class, a process-wide, thread-safe
+ * LRU cache of loaded flowshop instances.
+ * @version 0.1
+ * @date 2019-05-29
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __INSTANCECACHE_H
+#define __INSTANCECACHE_H
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "instance.h"
+
+namespace fshop
+{
+    /**
+     * @brief The InstanceCache class keeps recently loaded instances in memory so
+     * that repeated loads of the same file only pay for parsing and precomputation
+     * once. Entries are keyed by file path and are reloaded if the file's
+     * modification time or size changes. The least recently used entry is evicted
+     * once the capacity is reached.
+     * 
+     * --
+     * Load an instance through the process-wide cache:
+     * 
+     * InstancePtr inst = InstanceCache::global().get("DataFiles/1.txt");
+     */
+    class InstanceCache
+    {
+    public:
+        explicit InstanceCache(size_t _capacity = 128);
+
+        static InstanceCache& global();
+
+        InstancePtr get(const std::string& filePath);
+        void clear();
+        void setCapacity(size_t _capacity);
+        size_t getCapacity();
+        size_t getHits();
+        size_t getMisses();
+
+        // Delete copy/move constructors and assignments
+        InstanceCache(const InstanceCache& o) = delete;
+        InstanceCache(InstanceCache&& o) = delete;
+        InstanceCache& operator=(const InstanceCache& o) = delete;
+        InstanceCache& operator=(InstanceCache&& o) = delete;
+    private:
+        /**
+         * @brief A single cached instance and the file version it was loaded from
+         */
+        struct Entry
+        {
+            std::string filePath;
+            long long modTime;
+            long long fileSize;
+            InstancePtr instance;
+        };
+
+        std::list<Entry> entries; /** Cached entries, most recently used first */
+        std::unordered_map<std::string, std::list<Entry>::iterator> lookup; /** Maps file paths to entries */
+        std::mutex lock; /** Guards all members */
+        size_t capacity; /** Maximum number of cached entries */
+        size_t hits; /** Number of requests served from the cache */
+        size_t misses; /** Number of requests that loaded the file */
+
+        void evict();
+    };
+
+    /**
+     * @brief Restores the capacity an InstanceCache had when the scope was entered,
+     * so a capacity set for one batch does not carry over to the next.
+     * 
+     * --
+     * Limit the process-wide cache for the rest of a block:
+     * 
+     * {
+     *     ScopedCacheCapacity restore(InstanceCache::global());
+     *     InstanceCache::global().setCapacity(4);
+     * }
+     */
+    class ScopedCacheCapacity
+    {
+    public:
+        explicit ScopedCacheCapacity(InstanceCache& _cache)
+            : cache(_cache), capacity(_cache.getCapacity())
+        {
+        }
+
+        ~ScopedCacheCapacity()
+        {
+            cache.setCapacity(capacity);
+        }
+
+        // Delete copy/move constructors and assignments
+        ScopedCacheCapacity(const ScopedCacheCapacity& o) = delete;
+        ScopedCacheCapacity(ScopedCacheCapacity&& o) = delete;
+        ScopedCacheCapacity& operator=(const ScopedCacheCapacity& o) = delete;
+        ScopedCacheCapacity& operator=(ScopedCacheCapacity&& o) = delete;
+    private:
+        InstanceCache& cache; /** Cache whose capacity is restored */
+        size_t capacity; /** Capacity when the scope was entered */
+    };
+}
+
+#endif
+
+// =========================
+// End of instancecache.h
+// =========================
@@ -0,0 +1,92 @@
+/**
+ * @file instancegen.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the InstanceGenerator class, which produces synthetic
+ * flowshop instances from a seed using Taillard's random number generator.
+ * @version 0.1
+ * @date 2019-05-31
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __INSTANCEGEN_H
+#define __INSTANCEGEN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fshop
+{
+    /**
+     * @brief Processing time distributions supported by the generator
+     */
+    enum GenDistribution
+    {
+        GEN_UNIFORM = 0,            /** Uniform in [min, max], as in Taillard's benchmarks */
+        GEN_JOB_CORRELATED = 1,     /** Times of a job stay close to a per-job base time */
+        GEN_MACHINE_CORRELATED = 2  /** Times on a machine stay close to a per-machine base time */
+    };
+
+    bool parseGenDistribution(const std::string& name, GenDistribution& out);
+
+    /**
+     * @brief Taillard's portable linear congruential generator, from
+     * "Benchmarks for basic scheduling problems" (1993). Using the time seeds
+     * listed there with a uniform [1, 99] distribution reproduces the
+     * published benchmark instances exactly.
+     */
+    class TaillardRandom
+    {
+    public:
+        explicit TaillardRandom(int32_t _seed);
+
+        int unif(int low, int high);
+        int32_t getSeed() const;
+    private:
+        int32_t seed; /** Current generator state */
+    };
+
+    /**
+     * @brief The InstanceGenerator class produces the processing time matrix
+     * of a synthetic instance one machine row at a time, so instances of any
+     * size can be streamed to a file without holding the whole matrix.
+     *
+     * --
+     * Generate Taillard's first 20 job, 5 machine instance:
+     *
+     * InstanceGenerator gen(20, 5, 873654221);
+     * std::vector<int> row(20);
+     * for (size_t m = 0; m < 5; m++)
+     *     gen.nextRow(row.data());
+     */
+    class InstanceGenerator
+    {
+    public:
+        InstanceGenerator(size_t _jobs, size_t _machines, int32_t seed,
+                          GenDistribution _distribution = GEN_UNIFORM, int _minTime = 1, int _maxTime = 99);
+
+        void nextRow(int* row);
+        size_t getTotalJobs() const;
+        size_t getTotalMachines() const;
+    private:
+        TaillardRandom rand; /** Random number generator, continued across rows and instances */
+        size_t jobs; /** Number of columns (jobs) in every row */
+        size_t machines; /** Number of rows (machines) in the instance */
+        GenDistribution distribution; /** Processing time distribution */
+        int minTime; /** Smallest processing time */
+        int maxTime; /** Largest processing time */
+        int spread; /** Largest distance from the base time for correlated distributions */
+        std::vector<int> jobBase; /** Base time of every job for GEN_JOB_CORRELATED */
+
+        int correlated(int base);
+    };
+}
+
+#endif
+
+// =========================
+// End of instancegen.h
+// =========================
@@ -0,0 +1,134 @@
+/**
+ * @file instancepack.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the InstancePack class, which reads and writes packed
+ * binary files holding many flowshop instances behind a single index.
+ * @version 0.1
+ * @date 2019-05-28
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __INSTANCEPACK_H
+#define __INSTANCEPACK_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "fileview.h"
+#include "instance.h"
+
+namespace fshop
+{
+    /**
+     * @brief Index entry describing a single instance stored in a pack
+     */
+    struct PackEntry
+    {
+        int id; /** Instance number, as in the [NUM].txt file name */
+        size_t jobs; /** Number of columns (jobs) in the processing time matrix */
+        size_t machines; /** Number of rows (machines) in the processing time matrix */
+        uint64_t offset; /** Byte offset of the processing time matrix in the pack */
+    };
+
+    /**
+     * @brief The InstancePack class gives access to a pack file, a binary
+     * container of flowshop instances. The pack is memory-mapped when opened,
+     * and instances returned by getInstance() are zero-copy views into it.
+     * 
+     * Pack layout, all values little-endian:
+     * 
+     * Header (32 bytes): magic "FSHPACK\0", uint32 version, uint32 entry count,
+     * uint64 index offset, uint64 reserved.
+     * 
+     * Index (32 bytes per entry): int32 id, uint32 jobs, uint32 machines,
+     * uint32 reserved, uint64 matrix offset, uint64 reserved.
+     * 
+     * Matrices: int32 processing times, row-major [machine][job], each starting
+     * on a 64 byte boundary.
+     * 
+     * --
+     * Convert text instances 0.txt to 120.txt into a pack:
+     * 
+     * InstancePack::create("instances.pack", "DataFiles/", 0, 120);
+     * 
+     * --
+     * Open a pack and get an instance:
+     * 
+     * auto pack = InstancePack::open("instances.pack");
+     * InstancePtr inst = pack->getInstance(5);
+     */
+    class InstancePack : public std::enable_shared_from_this<InstancePack>
+    {
+    public:
+        static std::shared_ptr<InstancePack> open(const char* packFile);
+        static bool create(const char* packFile, const std::string& inputFilesDir, int minId, int maxId);
+        static bool isPackFile(const std::string& path);
+
+        bool contains(int id) const;
+        InstancePtr getInstance(int id) const;
+        const std::vector<PackEntry>& getEntries() const;
+        const std::string& getFilePath() const;
+
+        // Delete copy/move constructors and assignments
+        InstancePack(const InstancePack& o) = delete;
+        InstancePack(InstancePack&& o) = delete;
+        InstancePack& operator=(const InstancePack& o) = delete;
+        InstancePack& operator=(InstancePack&& o) = delete;
+    private:
+        InstancePack(const char* packFile);
+
+        util::FileView file; /** View of the complete pack file */
+        std::vector<PackEntry> entries; /** Index of all instances in the pack */
+        std::string filePath; /** Path of the pack file */
+
+        const PackEntry* findEntry(int id) const;
+    };
+
+    /**
+     * @brief The InstancePackWriter class streams instances into a new pack file
+     * one machine row at a time. The id and size of every instance must be known
+     * when the pack is opened, so the index can be written first.
+     * 
+     * --
+     * Write a pack holding one 3 job, 2 machine instance:
+     * 
+     * InstancePackWriter writer;
+     * writer.open("my.pack", { { 0, 3, 2, 0 } });
+     * writer.writeRow(row1, 3);
+     * writer.writeRow(row2, 3);
+     * bool success = writer.close();
+     */
+    class InstancePackWriter
+    {
+    public:
+        InstancePackWriter();
+        ~InstancePackWriter() = default;
+
+        bool open(const char* packFile, const std::vector<PackEntry>& _entries);
+        bool writeRow(const int* row, size_t cols);
+        bool close();
+
+        // Delete copy/move constructors and assignments
+        InstancePackWriter(const InstancePackWriter& o) = delete;
+        InstancePackWriter(InstancePackWriter&& o) = delete;
+        InstancePackWriter& operator=(const InstancePackWriter& o) = delete;
+        InstancePackWriter& operator=(InstancePackWriter&& o) = delete;
+    private:
+        std::ofstream os; /** Output pack file */
+        std::vector<PackEntry> entries; /** Index of all instances, with offsets filled in by open() */
+        std::vector<char> rowBytes; /** Little-endian encoding of the current row */
+        size_t curEntry; /** Index of the instance currently being written */
+        size_t curRow; /** Number of rows of the current instance written so far */
+        uint64_t pos; /** Current write position in the file */
+    };
+}
+
+#endif
+
+// =========================
+// End of instancepack.h
+// =========================
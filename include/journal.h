@@ -0,0 +1,71 @@
+/**
+ * @file journal.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the Journal class, which checkpoints completed results
+ * to an append-only file so an interrupted batch run can be resumed.
+ * @version 0.1
+ * @date 2019-06-01
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __JOURNAL_H
+#define __JOURNAL_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "csvwriter.h"
+
+namespace util
+{
+    /**
+     * @brief The Journal class appends one line per completed entry to a file.
+     * Each line holds a unique entry key followed by the entry's fields, all
+     * separated by commas, so neither keys nor fields may contain commas or
+     * line breaks. Entries are flushed as soon as they are written, and may be
+     * written from any thread.
+     *
+     * If the program stops while a line is being written, the line has no line
+     * break and is ignored when the journal is loaded. When a key appears more
+     * than once, the last entry wins.
+     *
+     * --
+     * Record an entry, then read it back in a later run:
+     *
+     * Journal journal;
+     * journal.open("run.journal", true);
+     * journal.write("fss#12", {"12", "1278"});
+     *
+     * std::map<std::string, std::vector<std::string>> done = Journal::load("run.journal");
+     */
+    class Journal
+    {
+    public:
+        Journal() = default;
+        ~Journal() = default;
+
+        bool open(const char* filePath, bool append, FsyncPolicy policy = FSYNC_NONE);
+        bool write(const std::string& key, const std::vector<std::string>& fields);
+        bool close();
+
+        static std::map<std::string, std::vector<std::string>> load(const char* filePath);
+
+        // Delete copy/move constructors and assignments
+        Journal(const Journal& o) = delete;
+        Journal(Journal&& o) = delete;
+        Journal& operator=(const Journal& o) = delete;
+        Journal& operator=(Journal&& o) = delete;
+    private:
+        CsvWriter out; /** Output file */
+        std::mutex lock; /** Serializes entries written from several threads */
+    };
+}
+
+#endif
+
+// =========================
+// End of journal.h
+// =========================
@@ -0,0 +1,95 @@
+/**
+ * @file jsonl.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the JsonRecord and JsonlWriter classes, which build JSON
+ * objects and append them to a JSON-lines file, one object per line.
+ * @version 0.1
+ * @date 2019-06-01
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __JSONL_H
+#define __JSONL_H
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include "csvwriter.h"
+
+namespace util
+{
+    /**
+     * @brief The JsonRecord class builds a single line JSON object. Keys are
+     * written as given, and must not need escaping. Text values are escaped.
+     * 
+     * --
+     * Build {"name":"fss","cmax":1278,"time":{"wallMs":1.5}}:
+     * 
+     * JsonRecord rec;
+     * rec.field("name", "fss").field("cmax", 1278);
+     * rec.beginObject("time").field("wallMs", 1.5).endObject();
+     * const std::string& line = rec.str();
+     */
+    class JsonRecord
+    {
+    public:
+        JsonRecord();
+
+        JsonRecord& field(const char* key, long long val);
+        JsonRecord& field(const char* key, unsigned long long val);
+        JsonRecord& field(const char* key, int val);
+        JsonRecord& field(const char* key, unsigned int val);
+        JsonRecord& field(const char* key, long val);
+        JsonRecord& field(const char* key, unsigned long val);
+        JsonRecord& field(const char* key, double val);
+        JsonRecord& field(const char* key, bool val);
+        JsonRecord& field(const char* key, std::nullptr_t);
+        JsonRecord& field(const char* key, const char* val);
+        JsonRecord& field(const char* key, const std::string& val);
+        JsonRecord& field(const char* key, const int* vals, size_t count);
+        JsonRecord& beginObject(const char* key);
+        JsonRecord& endObject();
+
+        const std::string& str();
+    private:
+        std::string text; /** Object text built so far */
+        bool first; /** True if the next field is the first of its object */
+        int depth; /** Number of objects currently open */
+
+        void key(const char* key);
+        void escaped(const char* val, size_t size);
+    };
+
+    /**
+     * @brief The JsonlWriter class appends JSON records to a file, one per line.
+     * Records may be written from any thread, and each record is flushed to the
+     * file as soon as it is written so the file can be followed while it grows.
+     */
+    class JsonlWriter
+    {
+    public:
+        JsonlWriter() = default;
+        ~JsonlWriter() = default;
+
+        bool open(const char* filePath, FsyncPolicy policy = FSYNC_NONE, bool append = false);
+        bool write(JsonRecord& record);
+        bool close();
+
+        // Delete copy/move constructors and assignments
+        JsonlWriter(const JsonlWriter& o) = delete;
+        JsonlWriter(JsonlWriter&& o) = delete;
+        JsonlWriter& operator=(const JsonlWriter& o) = delete;
+        JsonlWriter& operator=(JsonlWriter&& o) = delete;
+    private:
+        CsvWriter out; /** Output file */
+        std::mutex lock; /** Serializes records written from several threads */
+    };
+}
+
+#endif
+
+// =========================
+// End of jsonl.h
+// =========================
@@ -14,11 +14,16 @@
 
 #include <new> // std::nothrow
 #include <cstddef> // size_t definition
+#include <cstdint> // uintptr_t
+#include <vector>
+#include <limits>
+#include <type_traits>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include "fileview.h"
 
 namespace util
 {
@@ -88,7 +93,7 @@ namespace util
      * @brief Releases an allocated matrix's memory and sets the pointer to nullptr
      * 
      * @tparam Data type of the matrix
-     * @param m Pointer th the matrix
+     * @param m Pointer th the matrix, as returned by allocMatrix()
      * @param rows The number of rows in the matrix
      */
     template <class T = double>
@@ -96,16 +101,11 @@ namespace util
     {
         if (m == nullptr) return;
 
-        for (size_t i = 0; i < rows; i++)
-        {
-            if (m[i] != nullptr)
-            {
-                // Release each row
-                releaseArray<T>(m[i]);
-            }
-        }
+        // All rows share one block, which starts at the first row
+        if (rows > 0)
+            releaseArray<T>(m[0]);
 
-        // Release columns
+        // Release row pointers
         delete[] m;
         m = nullptr;
     }
@@ -124,7 +124,9 @@ namespace util
     }
 
     /**
-     * @brief Allocates a new matrix of the given data type
+     * @brief Allocates a new matrix of the given data type. All rows
+     * are stored in a single contiguous block, so the matrix must be
+     * released with releaseMatrix().
      * 
      * @tparam Data type of the matrix entries
      * @param rows The number of rows
@@ -135,90 +137,218 @@ namespace util
     inline T** allocMatrix(size_t rows, size_t cols)
     {
         T** m = (T**)allocArray<T*>(rows);
-        if (m == nullptr) return nullptr;
+        if (m == nullptr || rows == 0) return m;
 
-        for (size_t i = 0; i < rows; i++)
+        T* data = allocArray<T>(rows * cols);
+        if (data == nullptr)
         {
-            m[i] = allocArray<T>(cols);
-            if (m[i] == nullptr)
-            {
-                releaseMatrix<T>(m, rows);
-                return nullptr;
-            }
+            delete[] m;
+            return nullptr;
         }
 
+        for (size_t i = 0; i < rows; i++)
+            m[i] = data + i * cols;
+
         return m;
     }
 
-    template <class T = double>
+    /**
+     * @brief Advances past spaces, tabs and carriage returns, stopping at end of line
+     * 
+     * @param p Current position in the text
+     * @param end End of the text
+     * @return Returns the position of the first non-blank character
+     */
+    inline const char* skipBlanks(const char* p, const char* end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+
+        return p;
+    }
+
+    /**
+     * @brief Advances past the end of the current line
+     * 
+     * @param p Current position in the text
+     * @param end End of the text
+     * @return Returns the position of the first character of the next line
+     */
+    inline const char* skipLine(const char* p, const char* end)
+    {
+        while (p < end && *p != '\n')
+            p++;
+
+        return p < end ? p + 1 : p;
+    }
+
+    /**
+     * @brief Parses a decimal integer from the current line of a text buffer.
+     * Leading blanks are skipped, but the end of the line is never crossed.
+     * Locale independent and allocation free.
+     * 
+     * @tparam Integral type to parse
+     * @param p In/out current position in the text, advanced past the integer on success
+     * @param end End of the text
+     * @param out Out reference that receives the parsed value
+     * @return Returns true on success, or false if there is no valid integer on the line
+     */
+    template <class T>
+    inline bool scanInteger(const char*& p, const char* end, T& out)
+    {
+        static_assert(std::is_integral<T>::value, "scanInteger requires an integral type");
+
+        const char* cur = skipBlanks(p, end);
+
+        bool negative = false;
+        if (cur < end && (*cur == '-' || *cur == '+'))
+        {
+            negative = (*cur == '-');
+            cur++;
+        }
+
+        if (cur >= end || static_cast<unsigned char>(*cur - '0') > 9)
+            return false;
+        if (negative && !std::is_signed<T>::value)
+            return false;
+
+        const unsigned long long limit = negative ?
+            static_cast<unsigned long long>(std::numeric_limits<T>::max()) + 1 :
+            static_cast<unsigned long long>(std::numeric_limits<T>::max());
+
+        unsigned long long val = 0;
+        while (cur < end && static_cast<unsigned char>(*cur - '0') <= 9)
+        {
+            const unsigned digit = static_cast<unsigned char>(*cur - '0');
+            if (val > (limit - digit) / 10)
+                return false;
+
+            val = val * 10 + digit;
+            cur++;
+        }
+
+        out = negative ? static_cast<T>(0 - val) : static_cast<T>(val);
+        p = cur;
+        return true;
+    }
+
+    /**
+     * @brief Returns true if the line at p holds only the given keyword, such as
+     * the "due" line that starts a section of a data set file
+     * 
+     * @param p Start of the line
+     * @param end End of the text
+     * @param keyword Keyword to look for
+     */
+    inline bool isKeywordLine(const char* p, const char* end, const char* keyword)
+    {
+        const size_t len = std::char_traits<char>::length(keyword);
+
+        p = skipBlanks(p, end);
+        if (static_cast<size_t>(end - p) < len || std::char_traits<char>::compare(p, keyword, len) != 0)
+            return false;
+
+        p = skipBlanks(p + len, end);
+        return p >= end || *p == '\n';
+    }
+
+    /**
+     * @brief Reads every integer on the line at p
+     * 
+     * @param p In/out position, advanced to the start of the next line
+     * @param end End of the text
+     * @param values Out vector that receives the values
+     * @return Returns false if the line holds anything other than integers
+     */
+    inline bool readIntLine(const char*& p, const char* end, std::vector<int>& values)
+    {
+        int val = 0;
+        while (scanInteger<int>(p, end, val))
+            values.push_back(val);
+
+        p = skipBlanks(p, end);
+        const bool valid = p >= end || *p == '\n';
+
+        p = skipLine(p, end);
+        return valid;
+    }
+
+    /**
+     * @brief Loads a matrix of integers from a text file. The first line holds the
+     * number of rows and columns, and each following line holds one row of values.
+     * The file is memory-mapped and parsed in place straight into the new matrix.
+     * 
+     * @tparam Integral data type of the matrix entries
+     * @param filePath Path to the file, or "-" to read from stdin
+     * @param outNumRows Out reference that receives the number of rows
+     * @param outNumCols Out reference that receives the number of columns
+     * @return Returns a pointer to the new matrix, or nullptr on error
+     */
+    template <class T = int>
     inline T** loadMatrixFromFile(const char* filePath, size_t& outNumRows, size_t& outNumCols)
     {
         outNumRows = 0;
         outNumCols = 0;
 
-        std::ifstream is(filePath);
-        if (!is.good())
+        FileView file;
+        if (!file.open(filePath))
         {
             std::cerr << "Error loading matrix from file: Unable to open file." << std::endl;
             return nullptr;
         }
 
-        std::string line;
-        if (!std::getline(is, line))
+        const char* p = file.data();
+        const char* const end = p + file.size();
+
+        if (file.size() == 0)
         {
             std::cerr << "Error loading matrix from file: File is empty or invalid." << std::endl;
-            is.close();
             return nullptr;
         }
 
         size_t rows = 0;
         size_t cols = 0;
 
-        std::stringstream ss(line);
-        if (!(ss >> rows >> cols) || rows == 0 || cols == 0)
+        if (!scanInteger<size_t>(p, end, rows) || !scanInteger<size_t>(p, end, cols) || rows == 0 || cols == 0)
         {
             std::cerr << "Error loading matrix from file: Row or column size is zero." << std::endl;
-            is.close();
             return nullptr;
         }
 
+        p = skipLine(p, end);
 
         T** retMatrix = allocMatrix<T>(rows, cols);
         if (retMatrix == nullptr)
         {
             std::cerr << "Error loading matrix from file: Matrix memory allocation failed." << std::endl;
-            is.close();
             return nullptr;
         }
 
         for (size_t r = 0; r < rows; r++)
         {
-            if (!std::getline(is, line))
+            if (p >= end)
             {
                 std::cerr << "Error loading matrix from file: EOF reached before reading all rows." << std::endl;
                 releaseMatrix<T>(retMatrix, rows);
-                is.close();
                 return nullptr;
             }
 
-            std::stringstream ss(line);
+            T* row = retMatrix[r];
 
             for (size_t c = 0; c < cols; c++)
             {
-                T entry = 0;
-                if (!(ss >> entry))
+                if (!scanInteger<T>(p, end, row[c]))
                 {
                     std::cerr << "Error loading matrix from file: EOL reached before reading all cols." << std::endl;
                     releaseMatrix<T>(retMatrix, rows);
-                    is.close();
                     return nullptr;
                 }
-
-                retMatrix[r][c] = entry;
             }
+
+            // Ignore anything else on the line
+            p = skipLine(p, end);
         }
 
-        is.close();
         outNumRows = rows;
         outNumCols = cols;
         return retMatrix;
@@ -257,6 +387,233 @@ namespace util
         for (size_t i = 0; i < size; i++)
             dest[i] = src[i];
     }
+
+    /**
+     * @brief The Arena class is a simple bump-pointer allocator that hands out
+     * memory from large, reusable blocks. Individual allocations are never freed;
+     * instead the whole arena is rewound to a previous marker, or reset in bulk.
+     * Blocks obtained from the system are kept across resets, so a warmed-up arena
+     * serves all further allocations without touching the global allocator.
+     * 
+     * Only trivially constructible/destructible types should be placed in an arena.
+     * 
+     * --
+     * Get the arena owned by the calling thread:
+     * 
+     * util::Arena& arena = util::threadArena();
+     * 
+     * --
+     * Allocate a matrix, then release everything at once:
+     * 
+     * int** m = arena.allocMatrix<int>(rows, cols);
+     * arena.reset();
+     */
+    class Arena
+    {
+    public:
+        /**
+         * @brief Position within an arena, used to rewind allocations
+         */
+        struct Marker
+        {
+            size_t block;
+            size_t offset;
+        };
+
+        /**
+         * @brief Construct a new Arena object
+         * 
+         * @param _blockSize Minimum size in bytes of each block requested from the system
+         */
+        explicit Arena(size_t _blockSize = 256 * 1024)
+            : blockSize(_blockSize), curBlock(0), curOffset(0), allocsServed(0), bytesServed(0), bytesReserved(0)
+        {
+        }
+
+        /**
+         * @brief Destroys the Arena object and returns all blocks to the system
+         */
+        ~Arena()
+        {
+            for (auto& b : blocks)
+                delete[] b.data;
+        }
+
+        /**
+         * @brief Allocates raw memory from the arena
+         * 
+         * @param bytes Number of bytes to allocate
+         * @param align Required alignment, must be a power of two
+         * @return Returns a pointer to the memory, or nullptr if a new block could not be allocated
+         */
+        void* allocate(size_t bytes, size_t align = alignof(std::max_align_t))
+        {
+            if (bytes == 0) bytes = 1;
+
+            // Try the current block, then any blocks retained from before the last reset
+            while (curBlock < blocks.size())
+            {
+                void* p = bumpBlock(blocks[curBlock], bytes, align);
+                if (p != nullptr) return p;
+
+                curBlock++;
+                curOffset = 0;
+            }
+
+            // Out of space, request a new block from the system
+            size_t size = bytes + align > blockSize ? bytes + align : blockSize;
+            char* data = new(std::nothrow) char[size];
+            if (data == nullptr) return nullptr;
+
+            blocks.push_back({ data, size });
+            bytesReserved += size;
+            curBlock = blocks.size() - 1;
+            curOffset = 0;
+
+            return bumpBlock(blocks[curBlock], bytes, align);
+        }
+
+        /**
+         * @brief Allocates an uninitialized array from the arena
+         * 
+         * @tparam Data type of the array
+         * @param size Number of elements in the array
+         * @return Returns a pointer to the new array, or nullptr if allocation fails
+         */
+        template <class T = double>
+        T* allocArray(size_t size)
+        {
+            return static_cast<T*>(allocate(sizeof(T) * size, alignof(T)));
+        }
+
+        /**
+         * @brief Allocates an uninitialized matrix from the arena. All
+         * rows are stored in a single contiguous region.
+         * 
+         * @tparam Data type of the matrix entries
+         * @param rows The number of rows
+         * @param cols The number of columns
+         * @return Returns a pointer to the new matrix, or nullptr if allocation fails
+         */
+        template <class T = double>
+        T** allocMatrix(size_t rows, size_t cols)
+        {
+            T** m = allocArray<T*>(rows);
+            if (m == nullptr) return nullptr;
+
+            T* data = allocArray<T>(rows * cols);
+            if (data == nullptr) return nullptr;
+
+            for (size_t i = 0; i < rows; i++)
+                m[i] = data + i * cols;
+
+            return m;
+        }
+
+        /**
+         * @brief Returns a marker for the current arena position
+         */
+        Marker mark() const
+        {
+            return { curBlock, curOffset };
+        }
+
+        /**
+         * @brief Releases everything allocated since the given marker was taken
+         * 
+         * @param m Marker previously returned by mark()
+         */
+        void rewind(const Marker& m)
+        {
+            curBlock = m.block;
+            curOffset = m.offset;
+        }
+
+        /**
+         * @brief Releases all allocations at once. Blocks are kept for reuse.
+         */
+        void reset()
+        {
+            curBlock = 0;
+            curOffset = 0;
+        }
+
+        /**
+         * @brief Resets the allocation counters to zero
+         */
+        void resetCounters()
+        {
+            allocsServed = 0;
+            bytesServed = 0;
+        }
+
+        /**
+         * @brief Returns the number of allocations served since the counters were last reset
+         */
+        size_t getAllocsServed() const { return allocsServed; }
+
+        /**
+         * @brief Returns the number of bytes served since the counters were last reset
+         */
+        size_t getBytesServed() const { return bytesServed; }
+
+        /**
+         * @brief Returns the total number of bytes held by the arena's blocks
+         */
+        size_t getBytesReserved() const { return bytesReserved; }
+
+        // Delete copy/move constructors and assignments
+        Arena(const Arena& o) = delete;
+        Arena(Arena&& o) = delete;
+        Arena& operator=(const Arena& o) = delete;
+        Arena& operator=(Arena&& o) = delete;
+    private:
+        /**
+         * @brief A single block of memory obtained from the system
+         */
+        struct Block
+        {
+            char* data;
+            size_t size;
+        };
+
+        std::vector<Block> blocks; /** All blocks owned by this arena */
+        size_t blockSize; /** Minimum size of newly requested blocks */
+        size_t curBlock; /** Index of the block currently being bumped */
+        size_t curOffset; /** Offset of the next free byte in the current block */
+        size_t allocsServed; /** Number of allocations served */
+        size_t bytesServed; /** Number of bytes served */
+        size_t bytesReserved; /** Number of bytes obtained from the system */
+
+        /**
+         * @brief Attempts to carve an allocation out of the current block
+         * 
+         * @return Returns a pointer to the memory, or nullptr if the block is too small
+         */
+        void* bumpBlock(Block& b, size_t bytes, size_t align)
+        {
+            uintptr_t base = reinterpret_cast<uintptr_t>(b.data);
+            uintptr_t start = (base + curOffset + align - 1) & ~(static_cast<uintptr_t>(align) - 1);
+            size_t end = static_cast<size_t>(start - base) + bytes;
+            if (end > b.size) return nullptr;
+
+            curOffset = end;
+            allocsServed += 1;
+            bytesServed += bytes;
+            return reinterpret_cast<void*>(start);
+        }
+    };
+
+    /**
+     * @brief Returns the arena owned by the calling thread
+     * 
+     * @return Returns a reference to the thread-local arena
+     */
+    inline Arena& threadArena()
+    {
+        static thread_local Arena arena;
+        return arena;
+    }
 }
 
 #endif
@@ -0,0 +1,97 @@
+/**
+ * @file membudget.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the MemoryBudget class, which limits how much estimated
+ * memory the tasks of a batch may hold at once, and functions that read
+ * the resident memory of the process.
+ * @version 0.1
+ * @date 2019-06-05
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __MEMBUDGET_H
+#define __MEMBUDGET_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "canceltoken.h"
+
+namespace util
+{
+    size_t currentRssBytes();
+    size_t peakRssBytes();
+
+    /**
+     * @brief Bytes held in a memory budget on behalf of several requests, such as
+     * an instance shared by every variant run on it. Only the budget reads and
+     * changes it, while holding its lock.
+     */
+    struct SharedReservation
+    {
+        size_t bytes = 0; /** Bytes held while any of the requests runs */
+        bool held = false; /** True while the bytes are held in the budget */
+    };
+
+    /**
+     * @brief The MemoryBudget class admits work by its estimated memory. acquire()
+     * blocks until the bytes fit within the budget, and release() returns them.
+     * A request larger than the whole budget is admitted once nothing else
+     * holds any bytes, so it runs alone rather than never. A request may
+     * name a shared reservation, which is held along with the first request
+     * admitted and only counts as its own bytes when checking if it runs
+     * alone. A budget of zero bytes is unlimited, and never blocks.
+     *
+     * --
+     * Admit a task of 300 MB under a 1 GB budget:
+     *
+     * MemoryBudget budget(1024ull * 1024 * 1024);
+     * if (budget.acquire(300ull * 1024 * 1024, &cancelToken))
+     * {
+     *     runTask();
+     *     budget.release(300ull * 1024 * 1024);
+     * }
+     */
+    class MemoryBudget
+    {
+    public:
+        explicit MemoryBudget(size_t _limitBytes = 0);
+        ~MemoryBudget() = default;
+
+        void setLimit(size_t _limitBytes);
+        size_t getLimit() const;
+
+        bool acquire(size_t bytes, const CancelToken* cancelToken = nullptr, double* waitMs = nullptr, SharedReservation* shared = nullptr);
+        void release(size_t bytes);
+        void releaseShared(SharedReservation& shared);
+
+        size_t getReserved();
+        size_t getPeakReserved();
+        size_t getDelayedCount();
+        double getTotalWaitMs();
+        void resetStats();
+
+        // Delete copy/move constructors and assignments
+        MemoryBudget(const MemoryBudget& o) = delete;
+        MemoryBudget(MemoryBudget&& o) = delete;
+        MemoryBudget& operator=(const MemoryBudget& o) = delete;
+        MemoryBudget& operator=(MemoryBudget&& o) = delete;
+    private:
+        size_t limitBytes; /** Budget in bytes, or zero if unlimited */
+        size_t reserved; /** Bytes currently held */
+        size_t peakReserved; /** Most bytes held at once */
+        size_t delayedCount; /** Number of requests that had to wait */
+        double totalWaitMs; /** Time requests spent waiting, in milliseconds */
+        std::mutex lock; /** Guards all members */
+        std::condition_variable freed; /** Signalled whenever bytes are released */
+    };
+}
+
+#endif
+
+// =========================
+// End of membudget.h
+// =========================
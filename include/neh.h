@@ -16,7 +16,10 @@
 #include <list>
 #include <iostream>
 #include <random>
+#include <vector>
 #include "flowshopbasic.h"
+#include "mem.h"
+#include "canceltoken.h"
 
 using fsSol = std::unique_ptr<fshop::FlowshopSolution>;
 
@@ -40,21 +43,25 @@ namespace fshop
     /**
      * @brief The NEH class runs the NEH algorithm on the given flowshop
      * objective function and attempts to optimize the job sequence that
-     * produces the smallest cmax value.
+     * produces the smallest value of the chosen objective, cmax by default.
+     * The due date objectives need a flowshop with due dates.
      * 
      */
     class NEH
     {
     public:
-        NEH();
-        fsSol run(FlowshopBasic* const objectiveFs);
+        explicit NEH(unsigned int seed = 0, ObjectiveType _objective = OBJ_CMAX);
+        fsSol run(FlowshopBasic* const objectiveFs, const util::CancelToken* cancelToken = nullptr);
+
+        static size_t estimateBytes(size_t machines, size_t jobs);
     private:
         std::random_device rd;
         std::mt19937 randEngine;
         std::uniform_real_distribution<float> randChance;
+        ObjectiveType objective;
 
         void makeInitialAvailJobList(FlowshopBasic* const objectiveFs, std::list<fshop::JobTimePair>& outList);
-        fsSol bestPermutation(FlowshopBasic* const objectiveFs, const std::list<int>& baseList, int jobInsert, std::list<int>& outBestSeq);
+        ObjectiveValue bestPermutation(FlowshopBasic* const objectiveFs, util::Arena& arena, const std::list<int>& baseList, int jobInsert, std::list<int>& outBestSeq);
     };
 }
 
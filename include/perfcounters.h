@@ -0,0 +1,98 @@
+/**
+ * @file perfcounters.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the PerfCounters class, which reads hardware performance
+ * counters of the calling thread through Linux perf_event_open.
+ * @version 0.1
+ * @date 2019-06-02
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __PERFCOUNTERS_H
+#define __PERFCOUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+namespace util
+{
+    /**
+     * @brief Hardware events counted by PerfCounters
+     */
+    enum PerfEvent
+    {
+        PERF_CYCLES = 0,        /** CPU cycles */
+        PERF_INSTRUCTIONS = 1,  /** Retired instructions */
+        PERF_L1D_MISSES = 2,    /** Level 1 data cache read misses */
+        PERF_LLC_MISSES = 3,    /** Last level cache misses */
+        PERF_BRANCH_MISSES = 4, /** Mispredicted branches */
+        PERF_EVENT_COUNT = 5
+    };
+
+    /**
+     * @brief Event counts between PerfCounters::start() and PerfCounters::stop().
+     * An event is only valid if its counter could be opened and was scheduled
+     * on the CPU. Counts of multiplexed counters are scaled up to the full span.
+     */
+    struct PerfSample
+    {
+        uint64_t values[PERF_EVENT_COUNT] = { };
+        bool valid[PERF_EVENT_COUNT] = { };
+
+        bool has(PerfEvent e) const { return valid[e]; }
+        uint64_t get(PerfEvent e) const { return values[e]; }
+    };
+
+    /**
+     * @brief The PerfCounters class counts hardware events of the thread that
+     * opened it, in user space only. Each event is opened on its own, so events
+     * the CPU or kernel does not support are skipped and the rest still work.
+     * If no counter can be opened, such as in a container that blocks
+     * perf_event_open, every sample is simply empty.
+     *
+     * --
+     * Count the events of a kernel:
+     *
+     * PerfCounters perf;
+     * perf.open();
+     * perf.start();
+     * runKernel();
+     * PerfSample s = perf.stop();
+     * if (s.has(PERF_CYCLES)) cout << s.get(PERF_CYCLES) << endl;
+     */
+    class PerfCounters
+    {
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        bool open();
+        void close();
+        bool isAvailable() const;
+        const std::string& getError() const;
+
+        void start();
+        PerfSample stop();
+
+        static const char* eventName(PerfEvent e);
+
+        // Delete copy/move constructors and assignments
+        PerfCounters(const PerfCounters& o) = delete;
+        PerfCounters(PerfCounters&& o) = delete;
+        PerfCounters& operator=(const PerfCounters& o) = delete;
+        PerfCounters& operator=(PerfCounters&& o) = delete;
+    private:
+        int fds[PERF_EVENT_COUNT]; /** File descriptor of each counter, or -1 if unavailable */
+        std::string error; /** Why the first unavailable counter could not be opened */
+    };
+
+    PerfCounters& threadPerfCounters();
+}
+
+#endif
+
+// =========================
+// End of perfcounters.h
+// =========================
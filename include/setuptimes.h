@@ -0,0 +1,108 @@
+/**
+ * @file setuptimes.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the SetupTimes class, which holds the sequence-dependent
+ * setup times of a flowshop problem, and reads and writes them in the
+ * extended text format and a compact binary format.
+ * @version 0.1
+ * @date 2019-06-06
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __SETUPTIMES_H
+#define __SETUPTIMES_H
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "csvwriter.h"
+
+namespace fshop
+{
+    class SetupTimes;
+
+    using SetupTimesPtr = std::shared_ptr<const SetupTimes>;
+
+    /**
+     * @brief The SetupTimes class stores the m x n x n tensor of sequence-dependent
+     * setup times: the time machine m needs to change over from job i to job j
+     * before it can process j. The diagonal entry of a job is its initial setup,
+     * used when it is the first job of the sequence. Like Instance, setup times
+     * are immutable once loaded and can be shared between threads.
+     * 
+     * Files hold one n x n block per machine, each line being the setup times of
+     * one predecessor. In memory the tensor is stored contiguously by predecessor
+     * and then by successor, with the setup times of every machine for a pair of
+     * jobs next to each other. Evaluating one job on all machines then reads a
+     * single short run of memory, as with the instance's job-major matrix.
+     * 
+     * Text format: the data set file, followed by m blocks of n lines of n setup
+     * times. Blank lines between blocks are ignored.
+     * 
+     * Binary format (*.sdst), all values little-endian: magic "FSHSDST\0",
+     * uint32 version, uint32 machines, uint32 jobs, uint32 reserved, uint64 data
+     * offset, then int32 setup times in the in-memory order starting at the
+     * data offset. Binary files are memory-mapped and used in place.
+     * 
+     * --
+     * Get the setup times of every machine between job 3 and job 7:
+     * 
+     * SetupTimesPtr setups = SetupTimes::loadFromFile("DataFiles/1.txt");
+     * const int* times = setups->getSetupTimes(2, 6);
+     */
+    class SetupTimes
+    {
+    public:
+        static SetupTimesPtr loadFromFile(const char* filePath);
+        static SetupTimesPtr create(const std::vector<int>& machineBlocks, size_t machines, size_t jobs, const std::string& name);
+        static bool isBinaryFile(const std::string& path);
+        static size_t estimateBytes(size_t machines, size_t jobs);
+        ~SetupTimes() = default;
+
+        size_t getTotalMachines() const;
+        size_t getTotalJobs() const;
+        const std::string& getFilePath() const;
+
+        /**
+         * @brief Returns the setup times of every machine for a job following another.
+         * 
+         * @param pred Index of the preceding job [0, n), equal to succ for the initial setup
+         * @param succ Index of the following job [0, n)
+         * @return Returns a pointer to getTotalMachines() setup times, indexed [machine]
+         */
+        const int* getSetupTimes(size_t pred, size_t succ) const
+        {
+            return times + (pred * jobs + succ) * machines;
+        }
+
+        bool writeBinary(const char* filePath) const;
+        bool writeText(util::CsvWriter& txt) const;
+
+        // Delete copy/move constructors and assignments
+        SetupTimes(const SetupTimes& o) = delete;
+        SetupTimes(SetupTimes&& o) = delete;
+        SetupTimes& operator=(const SetupTimes& o) = delete;
+        SetupTimes& operator=(SetupTimes&& o) = delete;
+    private:
+        SetupTimes(size_t _machines, size_t _jobs, const std::string& _filePath);
+
+        const int* times; /** Setup times, stored [pred][succ][machine] in owned or storage */
+        std::vector<int> owned; /** The setup times if owned by this object */
+        std::shared_ptr<const void> storage; /** Keeps a mapped binary file alive */
+        size_t machines; /** Number of machines */
+        size_t jobs; /** Number of jobs */
+        std::string filePath; /** Path of the file the setup times were loaded from */
+
+        static SetupTimesPtr loadText(const char* filePath, const char* p, const char* end);
+        static SetupTimesPtr loadBinary(const char* filePath, std::shared_ptr<const void> file, const char* data, size_t size);
+    };
+}
+
+#endif
+
+// =========================
+// End of setuptimes.h
+// =========================
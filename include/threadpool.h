@@ -38,6 +38,37 @@
 #include <future>
 #include <functional>
 #include <stdexcept>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <ostream>
+#include <iomanip>
+#include <cstdint>
+
+// number of queue latency histogram buckets, bucket i counts
+// latencies in [2^i, 2^(i+1)) nanoseconds
+#define THREADPOOL_LATENCY_BUCKETS 40
+
+// counters of a single worker thread
+struct ThreadPoolWorkerStats {
+    uint64_t tasks;          // tasks executed
+    int64_t busyNanos;       // time spent running tasks
+    int64_t idleNanos;       // time spent waiting for tasks
+    int64_t lockWaitNanos;   // time spent blocked on the queue mutex
+};
+
+// snapshot of the counters of a pool, see ThreadPool::getStats()
+struct ThreadPoolStats {
+    std::vector<ThreadPoolWorkerStats> workers;
+    uint64_t latencyHist[THREADPOOL_LATENCY_BUCKETS]; // enqueue to start latency of every started task
+    uint64_t enqueued;                 // tasks enqueued
+    uint64_t maxQueueDepth;            // most tasks waiting in the queue at once
+    int64_t enqueueLockWaitNanos;      // time enqueue() spent blocked on the queue mutex
+
+    uint64_t tasks() const;
+    int64_t latencyPercentileNanos(double pct) const;
+    void print(std::ostream& out, const std::string& name) const;
+};
 
 class ThreadPool {
 public:
@@ -48,44 +79,110 @@ public:
     ~ThreadPool();
 
     void stopAndJoinAll();
+
+    // counters are safe to read while tasks are running
+    ThreadPoolStats getStats() const;
+    // print a summary to the stream when the pool is stopped
+    void setStatsOutput(std::ostream* out, const std::string& name);
 private:
+    using clock = std::chrono::steady_clock;
+
+    // a queued task and when it was enqueued
+    struct QueuedTask {
+        std::function<void()> run;
+        clock::time_point enqueuedAt;
+    };
+
+    // counters of one worker, only written by that worker. The padding
+    // keeps the counters of neighbouring workers off each other's cache lines.
+    struct WorkerCounters {
+        std::atomic<uint64_t> tasks;
+        std::atomic<int64_t> busyNanos;
+        std::atomic<int64_t> idleNanos;
+        std::atomic<int64_t> lockWaitNanos;
+        std::atomic<uint64_t> latencyHist[THREADPOOL_LATENCY_BUCKETS];
+        char padding[64];
+
+        WorkerCounters();
+    };
+
+    void workerLoop(size_t index);
+
+    static int64_t nanosBetween(clock::time_point from, clock::time_point to);
+    static size_t latencyBucket(int64_t nanos);
+    template<class T>
+    static void addRelaxed(std::atomic<T>& counter, T value);
+
     // need to keep track of threads so we can join them
     std::vector< std::thread > workers;
     // the task queue
-    std::queue< std::function<void()> > tasks;
+    std::queue< QueuedTask > tasks;
     
     // synchronization
     std::mutex queue_mutex;
     std::condition_variable condition;
     bool stop;
+
+    // telemetry
+    std::unique_ptr< WorkerCounters[] > counters;
+    std::atomic<uint64_t> enqueued;
+    std::atomic<uint64_t> maxQueueDepth;
+    std::atomic<int64_t> enqueueLockWaitNanos;
+    std::ostream* statsOut;
+    std::string statsName;
+    bool statsPrinted;
 };
+
+inline ThreadPool::WorkerCounters::WorkerCounters()
+    :   tasks(0), busyNanos(0), idleNanos(0), lockWaitNanos(0)
+{
+    for(auto& bucket : latencyHist)
+        bucket.store(0, std::memory_order_relaxed);
+}
  
 // the constructor just launches some amount of workers
 inline ThreadPool::ThreadPool(size_t threads)
-    :   stop(false)
+    :   stop(false), counters(new WorkerCounters[threads]), enqueued(0), maxQueueDepth(0),
+        enqueueLockWaitNanos(0), statsOut(nullptr), statsPrinted(false)
 {
     for(size_t i = 0;i<threads;++i)
-        workers.emplace_back(
-            [this]
-            {
-                for(;;)
-                {
-                    std::function<void()> task;
-
-                    {
-                        std::unique_lock<std::mutex> lock(this->queue_mutex);
-                        this->condition.wait(lock,
-                            [this]{ return this->stop || !this->tasks.empty(); });
-                        if(this->stop && this->tasks.empty())
-                            return;
-                        task = std::move(this->tasks.front());
-                        this->tasks.pop();
-                    }
-
-                    task();
-                }
-            }
-        );
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+// run tasks until the pool is stopped and the queue is empty, timing
+// the mutex wait, the wait for a task and the task itself
+inline void ThreadPool::workerLoop(size_t index)
+{
+    WorkerCounters& c = counters[index];
+
+    for(;;)
+    {
+        QueuedTask task;
+
+        clock::time_point requested = clock::now();
+        {
+            std::unique_lock<std::mutex> lock(this->queue_mutex);
+            clock::time_point locked = clock::now();
+            addRelaxed(c.lockWaitNanos, nanosBetween(requested, locked));
+
+            this->condition.wait(lock,
+                [this]{ return this->stop || !this->tasks.empty(); });
+            addRelaxed(c.idleNanos, nanosBetween(locked, clock::now()));
+
+            if(this->stop && this->tasks.empty())
+                return;
+            task = std::move(this->tasks.front());
+            this->tasks.pop();
+        }
+
+        clock::time_point started = clock::now();
+        addRelaxed(c.latencyHist[latencyBucket(nanosBetween(task.enqueuedAt, started))], static_cast<uint64_t>(1));
+
+        task.run();
+
+        addRelaxed(c.busyNanos, nanosBetween(started, clock::now()));
+        addRelaxed(c.tasks, static_cast<uint64_t>(1));
+    }
 }
 
 // add new work item to the pool
@@ -101,13 +198,21 @@ auto ThreadPool::enqueue(F&& f, Args&&... args)
         
     std::future<return_type> res = task->get_future();
     {
+        clock::time_point requested = clock::now();
         std::unique_lock<std::mutex> lock(queue_mutex);
+        clock::time_point locked = clock::now();
+        enqueueLockWaitNanos.fetch_add(nanosBetween(requested, locked), std::memory_order_relaxed);
 
         // don't allow enqueueing after stopping the pool
         if(stop)
             throw std::runtime_error("enqueue on stopped ThreadPool");
 
-        tasks.emplace([task](){ (*task)(); });
+        tasks.push(QueuedTask{ [task](){ (*task)(); }, locked });
+
+        // only changed while holding the lock
+        enqueued.store(enqueued.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if(tasks.size() > maxQueueDepth.load(std::memory_order_relaxed))
+            maxQueueDepth.store(tasks.size(), std::memory_order_relaxed);
     }
     condition.notify_one();
     return res;
@@ -128,7 +233,120 @@ inline void ThreadPool::stopAndJoinAll()
 
     condition.notify_all();
     for(std::thread &worker: workers)
-        worker.join();
+        if(worker.joinable())
+            worker.join();
+
+    if(statsOut != nullptr && !statsPrinted)
+    {
+        getStats().print(*statsOut, statsName);
+        statsPrinted = true;
+    }
+}
+
+inline ThreadPoolStats ThreadPool::getStats() const
+{
+    ThreadPoolStats stats = { };
+
+    for(size_t i = 0;i<workers.size();++i)
+    {
+        const WorkerCounters& c = counters[i];
+        ThreadPoolWorkerStats w;
+        w.tasks = c.tasks.load(std::memory_order_relaxed);
+        w.busyNanos = c.busyNanos.load(std::memory_order_relaxed);
+        w.idleNanos = c.idleNanos.load(std::memory_order_relaxed);
+        w.lockWaitNanos = c.lockWaitNanos.load(std::memory_order_relaxed);
+        stats.workers.push_back(w);
+
+        for(size_t b = 0;b<THREADPOOL_LATENCY_BUCKETS;++b)
+            stats.latencyHist[b] += c.latencyHist[b].load(std::memory_order_relaxed);
+    }
+
+    stats.enqueued = enqueued.load(std::memory_order_relaxed);
+    stats.maxQueueDepth = maxQueueDepth.load(std::memory_order_relaxed);
+    stats.enqueueLockWaitNanos = enqueueLockWaitNanos.load(std::memory_order_relaxed);
+    return stats;
+}
+
+inline void ThreadPool::setStatsOutput(std::ostream* out, const std::string& name)
+{
+    statsOut = out;
+    statsName = name;
+}
+
+inline int64_t ThreadPool::nanosBetween(clock::time_point from, clock::time_point to)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+inline size_t ThreadPool::latencyBucket(int64_t nanos)
+{
+    size_t bucket = 0;
+    while(nanos > 1 && bucket + 1 < THREADPOOL_LATENCY_BUCKETS)
+    {
+        nanos >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+// counters have a single writer, so a plain load and store is enough
+template<class T>
+inline void ThreadPool::addRelaxed(std::atomic<T>& counter, T value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+inline uint64_t ThreadPoolStats::tasks() const
+{
+    uint64_t total = 0;
+    for(auto& w : workers)
+        total += w.tasks;
+    return total;
+}
+
+// upper bound of the histogram bucket that contains the percentile
+inline int64_t ThreadPoolStats::latencyPercentileNanos(double pct) const
+{
+    uint64_t total = 0;
+    for(auto count : latencyHist)
+        total += count;
+    if(total == 0)
+        return 0;
+
+    uint64_t rank = static_cast<uint64_t>(pct / 100.0 * static_cast<double>(total) + 0.5);
+    if(rank < 1) rank = 1;
+
+    uint64_t seen = 0;
+    for(size_t b = 0;b<THREADPOOL_LATENCY_BUCKETS;++b)
+    {
+        seen += latencyHist[b];
+        if(seen >= rank)
+            return static_cast<int64_t>(1) << (b + 1);
+    }
+    return static_cast<int64_t>(1) << THREADPOOL_LATENCY_BUCKETS;
+}
+
+inline void ThreadPoolStats::print(std::ostream& out, const std::string& name) const
+{
+    out << "Thread pool " << name << ": " << workers.size() << " workers, " << tasks() << " of "
+        << enqueued << " tasks run, max queue depth " << maxQueueDepth << std::endl;
+    out << std::fixed << std::setprecision(2);
+
+    for(size_t i = 0;i<workers.size();++i)
+    {
+        const ThreadPoolWorkerStats& w = workers[i];
+        const int64_t total = w.busyNanos + w.idleNanos + w.lockWaitNanos;
+        out << "  Worker " << i << ": tasks=" << w.tasks << " busy=" << w.busyNanos / 1e6 << "ms idle="
+            << w.idleNanos / 1e6 << "ms lockWait=" << w.lockWaitNanos / 1e6 << "ms utilization="
+            << (total > 0 ? 100.0 * w.busyNanos / total : 0.0) << "%" << std::endl;
+    }
+
+    out << std::setprecision(3) << "  Queue latency: p50<=" << latencyPercentileNanos(50) / 1e6 << "ms p90<="
+        << latencyPercentileNanos(90) / 1e6 << "ms p99<=" << latencyPercentileNanos(99) / 1e6
+        << "ms max<=" << latencyPercentileNanos(100) / 1e6 << "ms, enqueue lockWait="
+        << enqueueLockWaitNanos / 1e6 << "ms" << std::endl;
+
+    out << std::defaultfloat << std::setprecision(6);
 }
 
 #endif
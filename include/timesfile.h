@@ -0,0 +1,96 @@
+/**
+ * @file timesfile.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the TimesFile class, which writes and reads the compact
+ * binary form of a flowshop solution's start and departure time matrices.
+ * @version 0.1
+ * @date 2019-05-30
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __TIMESFILE_H
+#define __TIMESFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "csvwriter.h"
+
+namespace fshop
+{
+    /**
+     * @brief Output formats for the start and departure time matrices
+     */
+    enum TimesFormat
+    {
+        TIMES_CSV = 0, /** Two *.csv files, one per matrix */
+        TIMES_BIN = 1  /** One compact binary *.bin file */
+    };
+
+    TimesFormat parseTimesFormat(const std::string& name);
+
+    /**
+     * @brief Start and departure time matrices decoded from a binary times file.
+     * Both matrices are stored row-major, [machine][sequence position].
+     */
+    struct TimesData
+    {
+        size_t machines = 0;
+        size_t jobs = 0;
+        std::vector<int> jobSequence;
+        std::vector<int> startTimes;
+        std::vector<int> departTimes;
+
+        int getStart(size_t m, size_t j) const { return startTimes[m * jobs + j]; }
+        int getDepart(size_t m, size_t j) const { return departTimes[m * jobs + j]; }
+    };
+
+    /**
+     * @brief The TimesFile class converts time matrices to and from the binary
+     * times format. Start times in a machine row never decrease, so each start
+     * is stored as the delta from the previous start in the row, and each
+     * departure as its distance from the matching start. All values are zigzag
+     * encoded varints, which takes one or two bytes for most entries. The
+     * encoded block can then be compressed with zlib when it is available.
+     *
+     * File layout, all values little-endian:
+     *
+     * Header (32 bytes): magic "FSTIMES\0", uint32 version, uint32 flags,
+     * uint32 machines, uint32 jobs, uint64 size of the uncompressed block.
+     *
+     * Block: varint job sequence, then for each machine the start deltas
+     * followed by the departure distances. If flag bit 0 is set the block
+     * is stored as a zlib stream.
+     *
+     * --
+     * Write a solution and read it back:
+     *
+     * TimesFile::write("times.bin", seq, start, depart, machines, jobs, true);
+     * TimesData data = TimesFile::read("times.bin");
+     */
+    class TimesFile
+    {
+    public:
+        static bool write(const char* filePath, const int* jobSeq, const int* const* startTimes, const int* const* departTimes,
+                          size_t machines, size_t jobs, bool compress, util::FsyncPolicy policy = util::FSYNC_NONE);
+        static TimesData read(const char* filePath);
+        static bool compressionAvailable();
+
+        static bool exportCsv(const TimesData& data, const std::string& fileNamePrefix);
+        static bool exportGantt(const TimesData& data, const char* filePath);
+
+        static void writeGanttHeader(util::CsvWriter& csv);
+        static size_t writeGanttRows(util::CsvWriter& csv, size_t firstItem, size_t machine, const int* startTimes, const int* departTimes, size_t jobs);
+    private:
+        static void encode(std::string& out, const int* jobSeq, const int* const* startTimes, const int* const* departTimes, size_t machines, size_t jobs);
+        static void decode(const char* p, const char* end, TimesData& data);
+    };
+}
+
+#endif
+
+// =========================
+// End of timesfile.h
+// =========================
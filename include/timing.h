@@ -0,0 +1,156 @@
+/**
+ * @file timing.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the PhaseClock class, which measures the wall clock
+ * and CPU time spent by the calling thread in a phase of work, and the
+ * scoped phase timers that add up where each thread spends its time.
+ * @version 0.1
+ * @date 2019-06-01
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __TIMING_H
+#define __TIMING_H
+
+#include <chrono>
+#include <cstdint>
+#include "alloctrack.h"
+
+namespace util
+{
+    double threadCpuTimeMs();
+
+    /**
+     * @brief Wall clock and thread CPU time of a phase, in milliseconds
+     */
+    struct PhaseTime
+    {
+        double wallMs = 0.0;
+        double cpuMs = 0.0;
+    };
+
+    /**
+     * @brief The PhaseClock class measures elapsed wall clock time and the
+     * CPU time of the thread it was started on. A clock must be read on the
+     * same thread that started it.
+     * 
+     * --
+     * Time a phase of work:
+     * 
+     * PhaseClock clock;
+     * doWork();
+     * PhaseTime t = clock.elapsed();
+     */
+    class PhaseClock
+    {
+    public:
+        PhaseClock();
+
+        void restart();
+        PhaseTime elapsed() const;
+    private:
+        std::chrono::steady_clock::time_point wallStart; /** Wall clock time when started */
+        double cpuStart; /** Thread CPU time when started, in milliseconds */
+    };
+
+    /**
+     * @brief Phases of work measured by scoped phase timers
+     */
+    enum TimedPhase
+    {
+        PHASE_LOAD = 0,       /** Loading an instance and creating its flowshop */
+        PHASE_SORT = 1,       /** Building and sorting NEH's initial job list */
+        PHASE_INSERTION = 2,  /** NEH insertion steps, including their evaluations */
+        PHASE_EVALUATION = 3, /** Objective function evaluations of NEH candidates */
+        PHASE_OUTPUT = 4,     /** Writing time matrix and Gantt files */
+        PHASE_COUNT = 5
+    };
+
+    const char* phaseName(TimedPhase phase);
+
+    /**
+     * @brief Wall clock time, number of timed scopes, and heap allocations of
+     * every phase. Allocations are only counted in FSHOP_ALLOC_TRACKING builds.
+     */
+    struct PhaseTotals
+    {
+        int64_t nanos[PHASE_COUNT] = { };
+        uint64_t count[PHASE_COUNT] = { };
+        uint64_t allocs[PHASE_COUNT] = { };
+        uint64_t allocBytes[PHASE_COUNT] = { };
+
+        double getMs(TimedPhase phase) const { return static_cast<double>(nanos[phase]) / 1000000.0; }
+        void add(const PhaseTotals& o);
+        PhaseTotals since(const PhaseTotals& earlier) const;
+    };
+
+    PhaseTotals& threadPhaseTotals();
+
+    /**
+     * @brief The ScopedPhaseTimer class adds the wall clock time between its
+     * construction and destruction to the calling thread's phase totals.
+     * Use the FSHOP_TIME_PHASE macro instead of this class directly, so the
+     * timers can be removed when building with FSHOP_NO_PHASE_TIMERS.
+     * 
+     * --
+     * Time the rest of a block as an evaluation:
+     * 
+     * {
+     *     FSHOP_TIME_PHASE(util::PHASE_EVALUATION);
+     *     value = objectiveFs->evaluate(seq, seqSize);
+     * }
+     */
+    class ScopedPhaseTimer
+    {
+    public:
+        explicit ScopedPhaseTimer(TimedPhase _phase)
+            : phase(_phase), start(std::chrono::steady_clock::now())
+        {
+#if defined(FSHOP_ALLOC_TRACKING)
+            allocStart = threadAllocStats();
+#endif
+        }
+
+        ~ScopedPhaseTimer()
+        {
+            PhaseTotals& totals = threadPhaseTotals();
+            totals.nanos[phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            totals.count[phase] += 1;
+
+#if defined(FSHOP_ALLOC_TRACKING)
+            const AllocStats a = threadAllocStats();
+            totals.allocs[phase] += a.allocs - allocStart.allocs;
+            totals.allocBytes[phase] += a.bytes - allocStart.bytes;
+#endif
+        }
+
+        // Delete copy/move constructors and assignments
+        ScopedPhaseTimer(const ScopedPhaseTimer& o) = delete;
+        ScopedPhaseTimer(ScopedPhaseTimer&& o) = delete;
+        ScopedPhaseTimer& operator=(const ScopedPhaseTimer& o) = delete;
+        ScopedPhaseTimer& operator=(ScopedPhaseTimer&& o) = delete;
+    private:
+        TimedPhase phase; /** Phase the time is added to */
+        std::chrono::steady_clock::time_point start; /** Time the scope was entered */
+#if defined(FSHOP_ALLOC_TRACKING)
+        AllocStats allocStart; /** Allocation counts when the scope was entered */
+#endif
+    };
+}
+
+#define FSHOP_PHASE_CONCAT2(a, b) a##b
+#define FSHOP_PHASE_CONCAT(a, b) FSHOP_PHASE_CONCAT2(a, b)
+
+#if defined(FSHOP_NO_PHASE_TIMERS)
+    #define FSHOP_TIME_PHASE(phase) ((void)0)
+#else
+    #define FSHOP_TIME_PHASE(phase) util::ScopedPhaseTimer FSHOP_PHASE_CONCAT(phaseTimer_, __LINE__)(phase)
+#endif
+
+#endif
+
+// =========================
+// End of timing.h
+// =========================
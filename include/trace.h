@@ -0,0 +1,165 @@
+/**
+ * @file trace.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the Tracer class, which records timed events of every
+ * thread into per-thread ring buffers and writes them out as a Chrome
+ * Trace Event file, and the scoped trace events that record them.
+ * @version 0.1
+ * @date 2019-06-04
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "csvwriter.h"
+
+namespace util
+{
+    /**
+     * @brief A single complete event: a named span of time on one thread,
+     * with up to two integer arguments. Names must be string literals, so
+     * recording an event never allocates.
+     */
+    struct TraceEvent
+    {
+        const char* name;
+        const char* category;
+        int64_t beginNs;           /** Start time, relative to when tracing started */
+        int64_t durationNs;        /** Length of the span */
+        const char* argNames[2];   /** Argument names, or nullptr if unused */
+        int64_t args[2];           /** Argument values */
+    };
+
+    /**
+     * @brief The Tracer class collects trace events from any number of threads.
+     * Every thread records into its own ring buffer without locking, and the
+     * oldest events of a thread are overwritten once its buffer is full. The
+     * buffers are only read by writeChromeTrace(), which must be called while
+     * no thread is recording, such as after the thread pools are joined.
+     *
+     * --
+     * Trace a batch and write a file for chrome://tracing or ui.perfetto.dev:
+     *
+     * Tracer::global().start(1 << 16);
+     * runBatch();
+     * Tracer::global().stop();
+     * Tracer::global().writeChromeTrace("trace.json");
+     */
+    class Tracer
+    {
+    public:
+        Tracer();
+        ~Tracer() = default;
+
+        static Tracer& global();
+
+        void start(size_t _eventsPerThread, unsigned int _stepSampling = 1);
+        void stop();
+        bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+        bool sampleStep(size_t step) const { return isEnabled() && step % stepSampling == 0; }
+
+        int64_t now() const;
+        void record(const TraceEvent& e);
+        void nameThread(const char* role);
+
+        bool writeChromeTrace(const char* filePath, FsyncPolicy policy = FSYNC_NONE);
+        uint64_t getDropped();
+
+        // Delete copy/move constructors and assignments
+        Tracer(const Tracer& o) = delete;
+        Tracer(Tracer&& o) = delete;
+        Tracer& operator=(const Tracer& o) = delete;
+        Tracer& operator=(Tracer&& o) = delete;
+    private:
+        /**
+         * @brief Ring buffer of the events of one thread, only written by that thread
+         */
+        struct ThreadBuffer
+        {
+            std::vector<TraceEvent> events;
+            uint64_t recorded = 0; /** Events recorded, the next one goes to recorded % capacity */
+            int tid = 0;
+            std::string name;
+            unsigned int generation = 0; /** Tracing session the buffer belongs to */
+        };
+
+        std::atomic<bool> enabled; /** True while events are recorded */
+        std::chrono::steady_clock::time_point origin; /** Time tracing started */
+        size_t eventsPerThread; /** Capacity of each thread's ring buffer */
+        unsigned int stepSampling; /** Only every Nth step of a repeated operation is traced */
+        unsigned int generation; /** Incremented by every start(), so old thread buffers are replaced */
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers; /** Buffers of every thread that recorded this session */
+        std::mutex lock; /** Guards buffers, only taken once per thread and session */
+
+        ThreadBuffer& threadBuffer();
+    };
+
+    /**
+     * @brief The ScopedTrace class records a trace event spanning its lifetime.
+     * Nothing is recorded, and the clock is not read, while tracing is disabled.
+     * Use the FSHOP_TRACE macros instead of this class directly.
+     */
+    class ScopedTrace
+    {
+    public:
+        ScopedTrace(const char* name, const char* category, const char* argName0 = nullptr, int64_t arg0 = 0,
+            const char* argName1 = nullptr, int64_t arg1 = 0)
+        {
+            Tracer& t = Tracer::global();
+            active = t.isEnabled();
+            if (!active) return;
+
+            e.name = name;
+            e.category = category;
+            e.argNames[0] = argName0;
+            e.argNames[1] = argName1;
+            e.args[0] = arg0;
+            e.args[1] = arg1;
+            e.beginNs = t.now();
+        }
+
+        ~ScopedTrace()
+        {
+            if (!active) return;
+
+            Tracer& t = Tracer::global();
+            e.durationNs = t.now() - e.beginNs;
+            t.record(e);
+        }
+
+        // Delete copy/move constructors and assignments
+        ScopedTrace(const ScopedTrace& o) = delete;
+        ScopedTrace(ScopedTrace&& o) = delete;
+        ScopedTrace& operator=(const ScopedTrace& o) = delete;
+        ScopedTrace& operator=(ScopedTrace&& o) = delete;
+    private:
+        bool active; /** True if tracing was enabled when the scope was entered */
+        TraceEvent e; /** Event being recorded */
+    };
+}
+
+#define FSHOP_TRACE_CONCAT2(a, b) a##b
+#define FSHOP_TRACE_CONCAT(a, b) FSHOP_TRACE_CONCAT2(a, b)
+
+#define FSHOP_TRACE(name, category) \
+    util::ScopedTrace FSHOP_TRACE_CONCAT(traceScope_, __LINE__)(name, category)
+#define FSHOP_TRACE_ARG(name, category, argName, arg) \
+    util::ScopedTrace FSHOP_TRACE_CONCAT(traceScope_, __LINE__)(name, category, argName, arg)
+#define FSHOP_TRACE_ARGS(name, category, argName0, arg0, argName1, arg1) \
+    util::ScopedTrace FSHOP_TRACE_CONCAT(traceScope_, __LINE__)(name, category, argName0, arg0, argName1, arg1)
+
+#endif
+
+// =========================
+// End of trace.h
+// =========================
@@ -0,0 +1,103 @@
+/**
+ * @file verify.h
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Contains the ResultsVerifier class, which compares NEH results
+ * against golden results and a stored timing baseline.
+ * @version 0.1
+ * @date 2019-06-03
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#ifndef __VERIFY_H
+#define __VERIFY_H
+
+#include <iostream>
+#include <map>
+#include <string>
+
+namespace cs471
+{
+    /**
+     * @brief How solution quality is compared against the golden results
+     */
+    enum QualityCheck
+    {
+        QUALITY_EXACT = 0,    /** cMax and TFT must match exactly, for runs with a fixed seed */
+        QUALITY_NO_WORSE = 1  /** cMax may not be worse than golden, within the quality tolerance */
+    };
+
+    bool parseQualityCheck(const std::string& name, QualityCheck& out);
+
+    /**
+     * @brief Exit codes of the verify command, apart from the codes of other errors
+     */
+    enum VerifyExitCode
+    {
+        VERIFY_PASSED = 0,          /** Every check passed */
+        VERIFY_QUALITY_FAILED = 10, /** Solution quality regressed, or golden data sets are missing */
+        VERIFY_TIME_FAILED = 11     /** Execution time regressed */
+    };
+
+    /**
+     * @brief Results of a single data set, as stored in a results *.csv file
+     */
+    struct ResultRecord
+    {
+        int cmax = 0;
+        int tft = 0;
+        double timeMs = 0.0;
+    };
+
+    /**
+     * @brief Results of a set of data sets, by data set number
+     */
+    using ResultSet = std::map<int, ResultRecord>;
+
+    /**
+     * @brief Verification thresholds of a single variant
+     */
+    struct VerifyParams
+    {
+        QualityCheck quality = QUALITY_NO_WORSE;
+        double qualityTolerance = 0.0; /** Allowed relative cMax increase for QUALITY_NO_WORSE */
+        double timeTolerance = 0.25;   /** Allowed relative increase of the total execution time */
+        double instanceTimeTolerance = 1.0; /** Allowed relative increase of each data set's execution time */
+        double timeFloorMs = 10.0;     /** Baseline time a data set needs to be checked on its own */
+        int timeRepetitions = 3;       /** Number of runs whose median time is compared to the baseline */
+    };
+
+    /**
+     * @brief The ResultsVerifier class compares the results of a run against golden
+     * results for quality, and against a baseline run for speed. Each check prints
+     * one line per failing data set and a summary line.
+     *
+     * Times are expected to be the median of several runs. The whole set is too
+     * slow if its total time exceeds the baseline total * (1 + timeTolerance). A
+     * data set whose baseline takes at least timeFloorMs is also too slow on its
+     * own if it takes longer than baseline * (1 + instanceTimeTolerance). Faster
+     * data sets are dominated by timer and scheduling noise, so they only count
+     * toward the total.
+     */
+    class ResultsVerifier
+    {
+    public:
+        ResultsVerifier(const std::string& _name, const VerifyParams& _params, std::ostream& _out);
+
+        static ResultSet readCsv(const std::string& filePath);
+
+        bool checkQuality(const ResultSet& golden, const ResultSet& actual);
+        bool checkTime(const ResultSet& baseline, const ResultSet& actual);
+    private:
+        std::string name; /** Name of the variant being verified, used in messages */
+        VerifyParams params; /** Verification thresholds */
+        std::ostream& out; /** Stream that receives the report */
+    };
+}
+
+#endif
+
+// =========================
+// End of verify.h
+// =========================
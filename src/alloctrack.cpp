@@ -0,0 +1,176 @@
+/**
+ * @file alloctrack.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the allocation tracking functions. When
+ * built with FSHOP_ALLOC_TRACKING, this file replaces the global operator
+ * new and delete with versions that count every allocation per thread.
+ * @version 0.1
+ * @date 2019-06-02
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <cstdlib>
+#include <new>
+#include "alloctrack.h"
+
+using namespace util;
+
+// Counts of the calling thread. The struct has no constructor, so the
+// thread_local is zero-initialized and safe to use from operator new.
+static thread_local AllocStats threadStats;
+
+/**
+ * @brief Returns the counts added after an earlier snapshot of the same thread's counts.
+ * The peak is relative to the live bytes of the snapshot, which is the high-water mark of
+ * the work in between if resetThreadAllocPeak() was called when the snapshot was taken.
+ * 
+ * @param earlier Snapshot taken earlier on the same thread
+ * @return Returns the difference between the counts
+ */
+AllocStats AllocStats::since(const AllocStats& earlier) const
+{
+    AllocStats diff;
+    diff.allocs = allocs - earlier.allocs;
+    diff.frees = frees - earlier.frees;
+    diff.bytes = bytes - earlier.bytes;
+    diff.bytesFreed = bytesFreed - earlier.bytesFreed;
+    diff.liveBytes = liveBytes - earlier.liveBytes;
+    diff.peakLiveBytes = peakLiveBytes - earlier.liveBytes;
+    return diff;
+}
+
+/**
+ * @brief Returns true if the program was built with FSHOP_ALLOC_TRACKING.
+ * Otherwise every count stays zero.
+ */
+bool util::allocTrackingEnabled()
+{
+#if defined(FSHOP_ALLOC_TRACKING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Returns a snapshot of the calling thread's allocation counts
+ */
+AllocStats util::threadAllocStats()
+{
+    return threadStats;
+}
+
+/**
+ * @brief Restarts the calling thread's peak live bytes from its current live bytes
+ */
+void util::resetThreadAllocPeak()
+{
+    threadStats.peakLiveBytes = threadStats.liveBytes;
+}
+
+#if defined(FSHOP_ALLOC_TRACKING)
+
+// Every block is prefixed with its size. The header is 16 bytes, so the
+// block keeps the alignment malloc gives it.
+static const size_t HEADER_SIZE = 16;
+
+/**
+ * @brief Allocates a counted block, calling the new handler until it succeeds
+ * 
+ * @param size Requested size in bytes
+ * @return Returns the block, or nullptr if it could not be allocated and there is no new handler
+ */
+static void* trackedAlloc(size_t size)
+{
+    char* p;
+    while ((p = static_cast<char*>(std::malloc(size + HEADER_SIZE))) == nullptr)
+    {
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) return nullptr;
+        handler();
+    }
+
+    *reinterpret_cast<size_t*>(p) = size;
+
+    AllocStats& s = threadStats;
+    s.allocs++;
+    s.bytes += size;
+    s.liveBytes += static_cast<int64_t>(size);
+    if (s.liveBytes > s.peakLiveBytes) s.peakLiveBytes = s.liveBytes;
+
+    return p + HEADER_SIZE;
+}
+
+/**
+ * @brief Frees a block returned by trackedAlloc()
+ * 
+ * @param ptr Pointer to the block, or nullptr
+ */
+static void trackedFree(void* ptr)
+{
+    if (ptr == nullptr) return;
+
+    char* p = static_cast<char*>(ptr) - HEADER_SIZE;
+    const size_t size = *reinterpret_cast<size_t*>(p);
+
+    AllocStats& s = threadStats;
+    s.frees++;
+    s.bytesFreed += size;
+    s.liveBytes -= static_cast<int64_t>(size);
+
+    std::free(p);
+}
+
+void* operator new(size_t size)
+{
+    void* p = trackedAlloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    void* p = trackedAlloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    try { return trackedAlloc(size); }
+    catch (...) { return nullptr; }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    try { return trackedAlloc(size); }
+    catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept
+{
+    trackedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    trackedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    trackedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    trackedFree(ptr);
+}
+
+#endif
+
+// =========================
+// End of alloctrack.cpp
+// =========================
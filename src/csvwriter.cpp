@@ -0,0 +1,378 @@
+/**
+ * @file csvwriter.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the CsvWriter class.
+ * @version 0.1
+ * @date 2019-05-29
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <cstring>
+#include "csvwriter.h"
+
+#if defined(_WIN32)
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+using namespace util;
+
+/**
+ * @brief Converts a policy name from a parameter file into an FsyncPolicy.
+ * Accepted names are "none", "close" and "flush".
+ * 
+ * @param name Name of the policy
+ * @return Returns the matching policy, or FSYNC_NONE if the name is unknown
+ */
+FsyncPolicy util::parseFsyncPolicy(const std::string& name)
+{
+    if (name == "close")
+        return FSYNC_ON_CLOSE;
+    else if (name == "flush")
+        return FSYNC_ON_FLUSH;
+    else
+        return FSYNC_NONE;
+}
+
+/**
+ * @brief Construct a new CsvWriter object
+ * 
+ * @param _bufferSize Size of the write buffer in bytes
+ */
+CsvWriter::CsvWriter(size_t _bufferSize)
+    : file(nullptr), buffer(nullptr), bufferSize(_bufferSize < 64 ? 64 : _bufferSize), used(0),
+      rowStart(true), error(false), precision(8), delimiter(','), policy(FSYNC_NONE)
+{
+    buffer = new char[bufferSize];
+}
+
+/**
+ * @brief Destroys the CsvWriter object, closing the file if it is still open
+ */
+CsvWriter::~CsvWriter()
+{
+    close();
+    delete[] buffer;
+}
+
+/**
+ * @brief Opens a file for writing, truncating any existing contents
+ * unless the file is opened for appending
+ * 
+ * @param filePath Path to the output file
+ * @param _policy When written data is forced to disk
+ * @param append If true, data is written after the existing contents
+ * @return Returns true if the file was opened. Otherwise false.
+ */
+bool CsvWriter::open(const char* filePath, FsyncPolicy _policy, bool append)
+{
+    close();
+
+    file = std::fopen(filePath, append ? "ab" : "wb");
+    if (file == nullptr) return false;
+
+    // The writer does its own buffering
+    std::setvbuf(file, nullptr, _IONBF, 0);
+
+    policy = _policy;
+    used = 0;
+    rowStart = true;
+    error = false;
+    return true;
+}
+
+/**
+ * @brief Writes all buffered data to the file
+ * 
+ * @return Returns true if no write has failed so far
+ */
+bool CsvWriter::flush()
+{
+    if (file == nullptr) return false;
+
+    writeBuffer();
+    if (policy == FSYNC_ON_FLUSH)
+        syncFile();
+
+    return !error;
+}
+
+/**
+ * @brief Writes all buffered data and closes the file
+ * 
+ * @return Returns true if all data was written successfully
+ */
+bool CsvWriter::close()
+{
+    if (file == nullptr) return false;
+
+    writeBuffer();
+    if (policy != FSYNC_NONE)
+        syncFile();
+
+    if (std::fclose(file) != 0)
+        error = true;
+
+    file = nullptr;
+    return !error;
+}
+
+/**
+ * @brief Returns true if a file is open and no write has failed
+ */
+bool CsvWriter::good() const
+{
+    return file != nullptr && !error;
+}
+
+/**
+ * @brief Appends raw bytes to the file, without field separators or quoting.
+ * Used to stream binary output through the same buffer and fsync policy.
+ * 
+ * @param data Pointer to the bytes to write
+ * @param size Number of bytes to write
+ * @return Returns a reference to this writer
+ */
+CsvWriter& CsvWriter::raw(const void* data, size_t size)
+{
+    write(static_cast<const char*>(data), size);
+    return *this;
+}
+
+/**
+ * @brief Sets the number of significant digits written for floating point values
+ * 
+ * @param _precision Number of significant digits
+ */
+void CsvWriter::setPrecision(int _precision)
+{
+    precision = _precision;
+}
+
+/**
+ * @brief Sets the character written between fields. Defaults to a comma.
+ * Text fields are only quoted for commas, so other delimiters are meant
+ * for numeric data such as the space separated instance files.
+ * 
+ * @param _delimiter Field delimiter
+ */
+void CsvWriter::setDelimiter(char _delimiter)
+{
+    delimiter = _delimiter;
+}
+
+/**
+ * @brief Appends a signed integer field to the current row
+ */
+CsvWriter& CsvWriter::field(long long val)
+{
+    separator();
+
+    // Format digits backwards into a small buffer
+    char tmp[24];
+    char* end = tmp + sizeof(tmp);
+    char* p = end;
+
+    unsigned long long mag = val < 0 ? 0ULL - static_cast<unsigned long long>(val) : static_cast<unsigned long long>(val);
+    do
+    {
+        *--p = static_cast<char>('0' + mag % 10);
+        mag /= 10;
+    } while (mag != 0);
+
+    if (val < 0) *--p = '-';
+
+    write(p, static_cast<size_t>(end - p));
+    return *this;
+}
+
+/**
+ * @brief Appends an unsigned integer field to the current row
+ */
+CsvWriter& CsvWriter::field(unsigned long long val)
+{
+    separator();
+
+    char tmp[24];
+    char* end = tmp + sizeof(tmp);
+    char* p = end;
+
+    do
+    {
+        *--p = static_cast<char>('0' + val % 10);
+        val /= 10;
+    } while (val != 0);
+
+    write(p, static_cast<size_t>(end - p));
+    return *this;
+}
+
+/**
+ * @brief Appends an integer field to the current row
+ */
+CsvWriter& CsvWriter::field(int val)
+{
+    return field(static_cast<long long>(val));
+}
+
+/**
+ * @brief Appends an unsigned integer field to the current row
+ */
+CsvWriter& CsvWriter::field(unsigned int val)
+{
+    return field(static_cast<unsigned long long>(val));
+}
+
+/**
+ * @brief Appends an integer field to the current row
+ */
+CsvWriter& CsvWriter::field(long val)
+{
+    return field(static_cast<long long>(val));
+}
+
+/**
+ * @brief Appends an unsigned integer field to the current row
+ */
+CsvWriter& CsvWriter::field(unsigned long val)
+{
+    return field(static_cast<unsigned long long>(val));
+}
+
+/**
+ * @brief Appends a floating point field to the current row, using the
+ * current precision in significant digits. The program never changes
+ * the C locale, so the decimal point is always '.'.
+ */
+CsvWriter& CsvWriter::field(double val)
+{
+    separator();
+
+    char tmp[64];
+    int len = std::snprintf(tmp, sizeof(tmp), "%.*g", precision, val);
+    if (len > 0)
+        write(tmp, static_cast<size_t>(len) < sizeof(tmp) ? static_cast<size_t>(len) : sizeof(tmp) - 1);
+
+    return *this;
+}
+
+/**
+ * @brief Appends a text field to the current row. The field is quoted
+ * if it contains a comma, quote or line break.
+ */
+CsvWriter& CsvWriter::field(const char* val)
+{
+    separator();
+
+    const size_t len = std::strlen(val);
+    if (std::strpbrk(val, ",\"\r\n") == nullptr)
+    {
+        write(val, len);
+        return *this;
+    }
+
+    write("\"", 1);
+    for (size_t i = 0; i < len; i++)
+    {
+        if (val[i] == '"')
+            write("\"\"", 2);
+        else
+            write(val + i, 1);
+    }
+    write("\"", 1);
+
+    return *this;
+}
+
+/**
+ * @brief Appends a text field to the current row
+ */
+CsvWriter& CsvWriter::field(const std::string& val)
+{
+    return field(val.c_str());
+}
+
+/**
+ * @brief Ends the current row
+ */
+CsvWriter& CsvWriter::endRow()
+{
+    write("\n", 1);
+    rowStart = true;
+    return *this;
+}
+
+/**
+ * @brief Writes a field separator unless the next field starts a row
+ */
+void CsvWriter::separator()
+{
+    if (!rowStart)
+        write(&delimiter, 1);
+
+    rowStart = false;
+}
+
+/**
+ * @brief Appends raw bytes to the write buffer, writing the buffer out when full
+ */
+void CsvWriter::write(const char* data, size_t size)
+{
+    if (file == nullptr) return;
+
+    if (used + size > bufferSize)
+    {
+        writeBuffer();
+
+        // Data larger than the whole buffer goes straight to the file
+        if (size > bufferSize)
+        {
+            if (std::fwrite(data, 1, size, file) != size)
+                error = true;
+
+            return;
+        }
+    }
+
+    std::memcpy(buffer + used, data, size);
+    used += size;
+}
+
+/**
+ * @brief Writes the contents of the buffer to the file
+ * 
+ * @return Returns true on success. Otherwise false.
+ */
+bool CsvWriter::writeBuffer()
+{
+    if (used > 0 && std::fwrite(buffer, 1, used, file) != used)
+        error = true;
+
+    used = 0;
+    return !error;
+}
+
+/**
+ * @brief Forces all data written to the file onto stable storage
+ * 
+ * @return Returns true on success. Otherwise false.
+ */
+bool CsvWriter::syncFile()
+{
+#if defined(_WIN32)
+    if (_commit(_fileno(file)) != 0)
+        error = true;
+#else
+    if (fsync(fileno(file)) != 0)
+        error = true;
+#endif
+
+    return !error;
+}
+
+// =========================
+// End of csvwriter.cpp
+// =========================
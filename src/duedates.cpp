@@ -0,0 +1,129 @@
+/**
+ * @file duedates.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the DueDates class.
+ * @version 0.1
+ * @date 2019-06-07
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <stdexcept>
+#include "duedates.h"
+#include "fileview.h"
+#include "mem.h"
+
+using namespace fshop;
+
+/**
+ * @brief Constructs a new DueDates object
+ * 
+ * @param _dueDates Due date of each job
+ * @param _weights Weight of each job
+ * @param _filePath Path of the file the due dates were loaded from
+ */
+DueDates::DueDates(const std::vector<int>& _dueDates, const std::vector<int>& _weights, const std::string& _filePath)
+    : dueDates(_dueDates), weights(_weights), filePath(_filePath)
+{
+}
+
+/**
+ * @brief Loads the due date section of a data set file or sidecar file
+ * 
+ * @param filePath Path to the file
+ * @return Returns a shared pointer to the due dates. Throws std::runtime_error on error.
+ */
+DueDatesPtr DueDates::loadFromFile(const char* filePath)
+{
+    util::FileView file;
+    if (!file.open(filePath))
+        throw std::runtime_error(std::string("Error opening due dates file: ") + filePath);
+
+    const char* p = file.data();
+    const char* const end = p + file.size();
+
+    // Find the section, which follows everything else in a data set file
+    while (p < end && !util::isKeywordLine(p, end, "due"))
+        p = util::skipLine(p, end);
+
+    if (p >= end)
+        throw std::runtime_error(std::string("Error: File has no due dates: ") + filePath);
+
+    p = util::skipLine(p, end);
+
+    std::vector<int> due;
+    std::vector<int> weights;
+
+    if (!util::readIntLine(p, end, due) || due.empty())
+        throw std::runtime_error(std::string("Error: Due dates are missing or invalid: ") + filePath);
+
+    if (p < end && util::isKeywordLine(p, end, "weights"))
+    {
+        p = util::skipLine(p, end);
+        if (!util::readIntLine(p, end, weights) || weights.size() != due.size())
+            throw std::runtime_error(std::string("Error: Weights are missing or invalid: ") + filePath);
+    }
+
+    return create(due, weights, filePath);
+}
+
+/**
+ * @brief Creates due dates from values in memory
+ * 
+ * @param _dueDates Due date of each job
+ * @param _weights Weight of each job, or empty for a weight of 1
+ * @param name Name describing where the due dates came from
+ * @return Returns a shared pointer to the new due dates
+ */
+DueDatesPtr DueDates::create(const std::vector<int>& _dueDates, const std::vector<int>& _weights, const std::string& name)
+{
+    if (_dueDates.empty())
+        throw std::invalid_argument("Error: Due dates cannot be empty");
+    else if (!_weights.empty() && _weights.size() != _dueDates.size())
+        throw std::invalid_argument("Error: There must be one weight per due date");
+
+    for (int w : _weights)
+    {
+        if (w < 0)
+            throw std::invalid_argument("Error: Weights cannot be negative: " + name);
+    }
+
+    return DueDatesPtr(new DueDates(_dueDates, _weights.empty() ? std::vector<int>(_dueDates.size(), 1) : _weights, name));
+}
+
+/**
+ * @brief Returns the number of jobs
+ */
+size_t DueDates::getTotalJobs() const
+{
+    return dueDates.size();
+}
+
+/**
+ * @brief Returns the due date of every job, indexed [job]
+ */
+const int* DueDates::getDueDates() const
+{
+    return dueDates.data();
+}
+
+/**
+ * @brief Returns the tardiness weight of every job, indexed [job]
+ */
+const int* DueDates::getWeights() const
+{
+    return weights.data();
+}
+
+/**
+ * @brief Returns the path of the file the due dates were loaded from
+ */
+const std::string& DueDates::getFilePath() const
+{
+    return filePath;
+}
+
+// =========================
+// End of duedates.cpp
+// =========================
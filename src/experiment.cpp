@@ -11,24 +11,68 @@
 
 #include <stdexcept>
 #include <vector>
+#include <map>
+#include <memory>
+#include <cstring>
 #include <thread>
 #include <future>
 #include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <set>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
 #include "experiment.h"
 #include "threadpool.h"
 #include "stringutils.h"
 #include "flowshopblocking.h"
 #include "flowshopnowait.h"
+#include "flowshopsdst.h"
+#include "flowshopbuffered.h"
 #include "neh.h"
+#include "mem.h"
+#include "instancecache.h"
+#include "timing.h"
+#include "perfcounters.h"
+#include "alloctrack.h"
+#include "trace.h"
+#include "membudget.h"
 
 #define INI_TEST_SECTION      "test"
+#define INI_TEST_VARIANT      "test."
 #define INI_TEST_MINFILE      "minTestFile"
 #define INI_TEST_MAXFILE      "maxTestFile"
 #define INI_TEST_NUMTHREADS   "numThreads"
 #define INI_TEST_ALGORITHM    "algorithm"
 #define INI_TEST_INPUTFILEDIR "inputFilesDir"
+#define INI_TEST_SETUPTIMESDIR "setupTimesDir"
+#define INI_TEST_DUEDATESDIR  "dueDatesDir"
+#define INI_TEST_OBJECTIVE    "objective"
+#define INI_TEST_BUFFERSIZES  "bufferSizes"
 #define INI_TEST_RESULTSFILE  "resultsFile"
 #define INI_TEST_TIMESFILE    "timesFile"
+#define INI_TEST_TIMESFORMAT  "timesFormat"
+#define INI_TEST_TIMESCOMPRESS "timesCompress"
+#define INI_TEST_GANTTDIR     "ganttDir"
+#define INI_TEST_JSONLFILE    "jsonlFile"
+#define INI_TEST_JOURNALFILE  "journalFile"
+#define INI_TEST_RESUME       "resume"
+#define INI_TEST_PERFCOUNTERS "perfCounters"
+#define INI_TEST_FSYNCPOLICY  "fsyncPolicy"
+#define INI_TEST_MAXMEMORYMB  "maxMemoryMB"
+#define INI_TEST_TRACEFILE    "traceFile"
+#define INI_TEST_TRACEEVENTS  "traceEventsPerThread"
+#define INI_TEST_TRACESAMPLING "traceStepSampling"
+#define INI_TEST_SEED         "seed"
+#define INI_TEST_GOLDENFILE   "goldenFile"
+#define INI_TEST_BASELINEFILE "baselineFile"
+#define INI_TEST_VERIFYQUALITY "verifyQuality"
+#define INI_TEST_QUALITYTOL   "qualityTolerance"
+#define INI_TEST_TIMETOL      "timeTolerance"
+#define INI_TEST_INSTTIMETOL  "instanceTimeTolerance"
+#define INI_TEST_TIMEFLOOR    "timeFloorMs"
+#define INI_TEST_TIMEREPS     "timeRepetitions"
 
 using namespace cs471;
 using namespace fshop;
@@ -36,6 +80,230 @@ using namespace util;
 using namespace std;
 using namespace chrono;
 
+/**
+ * @brief Number of columns in each NEH results table, without hardware counter columns
+ */
+static const size_t RESULTS_COLS = 16;
+
+/**
+ * @brief Results table column of the output phase time, filled in by the writer thread
+ */
+static const size_t RESULTS_OUTPUT_COL = 11;
+
+/**
+ * @brief Number of due date objective columns in results tables of variants with due dates
+ */
+static const size_t RESULTS_DUE_COLS = 3;
+
+/**
+ * @brief Number of allocation columns in results tables of allocation tracking builds
+ */
+static const size_t RESULTS_ALLOC_COLS = 4;
+
+/**
+ * @brief Largest accepted number of worker threads
+ */
+static const int MAX_THREADS = 256;
+
+/**
+ * @brief Returns the display name of the given flowshop algorithm
+ * 
+ * @param alg Index of the flowshop algorithm. 0 = Standard, 1 = With Blocking, 2 = With No Wait, 3 = With Setup Times,
+ * 4 = With Limited Buffers.
+ * @return Returns the name of the algorithm
+ */
+static const char* algorithmName(int alg)
+{
+    if (alg == 1)
+        return "Flow Shop with Blocking";
+    else if (alg == 2)
+        return "Flow Shop with No Wait";
+    else if (alg == 3)
+        return "Flow Shop with Setup Times";
+    else if (alg == 4)
+        return "Flow Shop with Limited Buffers";
+    else
+        return "Flow Shop Scheduling";
+}
+
+/**
+ * @brief Returns the name of a single input data set. Data sets are either
+ * [NUM].txt files within a directory, or entries within an instance pack.
+ * 
+ * @param inputFilesDir Input files directory, or path to a .pack file
+ * @param testIndex Number of the data set
+ * @return Returns the file path or pack entry name of the data set
+ */
+static string inputName(const string& inputFilesDir, int testIndex)
+{
+    if (InstancePack::isPackFile(inputFilesDir))
+        return inputFilesDir + "[" + std::to_string(testIndex) + "]";
+    else
+        return inputFilesDir + std::to_string(testIndex) + ".txt";
+}
+
+/**
+ * @brief Loads the sequence-dependent setup times of a single data set. They are read
+ * from [setupTimesDir][NUM].sdst if a setup times directory is given, and otherwise
+ * from the setup blocks that follow the processing times in the data set file.
+ * 
+ * @param p Experiment test parameters of the variant
+ * @param testIndex Number of the data set
+ * @return Returns a shared pointer to the setup times. Throws std::runtime_error on error.
+ */
+static SetupTimesPtr loadSetupTimes(const TestParams& p, int testIndex)
+{
+    if (!p.setupTimesDir.empty())
+        return SetupTimes::loadFromFile((p.setupTimesDir + std::to_string(testIndex) + ".sdst").c_str());
+    else if (InstancePack::isPackFile(p.inputFilesDir))
+        throw std::runtime_error("Error: Instance packs hold no setup times, setupTimesDir must be set for " + p.name);
+
+    return SetupTimes::loadFromFile(inputName(p.inputFilesDir, testIndex).c_str());
+}
+
+/**
+ * @brief Returns the buffer sizes of a single data set. The 'bufferSizes' entry of the
+ * variant applies to every data set, and otherwise they are read from the buffers
+ * section of the data set file.
+ * 
+ * @param p Experiment test parameters of the variant
+ * @param testIndex Number of the data set
+ * @return Returns the buffer sizes. Throws std::runtime_error on error.
+ */
+static vector<int> loadBufferSizes(const TestParams& p, int testIndex)
+{
+    if (!p.bufferSizes.empty())
+        return p.bufferSizes;
+    else if (InstancePack::isPackFile(p.inputFilesDir))
+        throw std::runtime_error("Error: Instance packs hold no buffer sizes, bufferSizes must be set for " + p.name);
+
+    return FlowshopBuffered::loadBufferSizes(inputName(p.inputFilesDir, testIndex).c_str());
+}
+
+/**
+ * @brief Returns true if a variant loads due dates: when it minimizes a due date
+ * objective, or when a due dates directory is given to report them for cmax runs
+ * 
+ * @param p Experiment test parameters of the variant
+ */
+static bool usesDueDates(const TestParams& p)
+{
+    return p.objective != OBJ_CMAX || !p.dueDatesDir.empty();
+}
+
+/**
+ * @brief Loads the due dates of a single data set. They are read from the sidecar
+ * file [dueDatesDir][NUM].due if a due dates directory is given, and otherwise from
+ * the due date section at the end of the data set file.
+ * 
+ * @param p Experiment test parameters of the variant
+ * @param testIndex Number of the data set
+ * @return Returns a shared pointer to the due dates. Throws std::runtime_error on error.
+ */
+static DueDatesPtr loadDueDates(const TestParams& p, int testIndex)
+{
+    if (!p.dueDatesDir.empty())
+        return DueDates::loadFromFile((p.dueDatesDir + std::to_string(testIndex) + ".due").c_str());
+    else if (InstancePack::isPackFile(p.inputFilesDir))
+        throw std::runtime_error("Error: Instance packs hold no due dates, dueDatesDir must be set for " + p.name);
+
+    return DueDates::loadFromFile(inputName(p.inputFilesDir, testIndex).c_str());
+}
+
+/**
+ * @brief Returns the number of columns in the results table of a variant.
+ * Variants with due dates get the due date objective columns, variants with
+ * hardware counters enabled get one extra column per event, and allocation
+ * tracking builds add the allocation columns.
+ * 
+ * @param p Test parameters of the variant
+ * @return Returns the number of columns
+ */
+static size_t resultsCols(const TestParams& p)
+{
+    return RESULTS_COLS + (usesDueDates(p) ? RESULTS_DUE_COLS : 0) + (p.perfCounters ? util::PERF_EVENT_COUNT : 0)
+        + (util::allocTrackingEnabled() ? RESULTS_ALLOC_COLS : 0);
+}
+
+/**
+ * @brief Returns the checkpoint journal key of a single (variant, data set) task
+ * 
+ * @param p Test parameters of the variant
+ * @param testIndex Number of the data set
+ * @return Returns the journal key
+ */
+static string journalKey(const TestParams& p, int testIndex)
+{
+    return p.name + "#" + std::to_string(testIndex);
+}
+
+/**
+ * @brief Fills in the matrix size of a shared input file from its file header or
+ * pack index, leaving it zero if it cannot be read
+ * 
+ * @param shared Shared input file slot
+ */
+static void readInstanceSize(SharedInstance& shared)
+{
+    if (shared.pack != nullptr)
+    {
+        for (auto& e : shared.pack->getEntries())
+        {
+            if (e.id != shared.testIndex) continue;
+
+            shared.machines = e.machines;
+            shared.jobs = e.jobs;
+            return;
+        }
+    }
+    else
+    {
+        Instance::readFileHeader(shared.inputFile.c_str(), shared.machines, shared.jobs);
+    }
+}
+
+/**
+ * @brief Reads the data set number, cMax, TFT and execution time of every row of a results table
+ * 
+ * @param table Results table of a variant
+ * @param p Test parameters of the variant
+ * @return Returns the results by data set number
+ */
+static ResultSet tableResults(mdata::DataTable<string>& table, const TestParams& p)
+{
+    ResultSet results;
+
+    for (int i = p.minTestFile; i <= p.maxTestFile; i++)
+    {
+        const size_t row = i - p.minTestFile;
+        if (table.getEntry(row, 1).empty()) continue;
+
+        ResultRecord rec;
+        rec.cmax = std::stoi(table.getEntry(row, 1));
+        rec.tft = std::stoi(table.getEntry(row, 2));
+        rec.timeMs = std::stod(table.getEntry(row, 4));
+        results[i] = rec;
+    }
+
+    return results;
+}
+
+/**
+ * @brief Returns the value at the given percentile of a sorted vector, by nearest rank
+ * 
+ * @param sorted Values sorted in ascending order
+ * @param pct Percentile, from 0 to 100
+ * @return Returns the value, or zero if there are no values
+ */
+static double percentile(const vector<double>& sorted, double pct)
+{
+    if (sorted.empty()) return 0.0;
+
+    size_t rank = static_cast<size_t>(std::ceil(pct / 100.0 * static_cast<double>(sorted.size())));
+    if (rank < 1) rank = 1;
+    return sorted[std::min(rank, sorted.size()) - 1];
+}
+
 /**
  * @brief Construct a Experiment object
  * 
@@ -46,84 +314,674 @@ Experiment::Experiment(string paramsFile)
     // Attempt to open parameters file
     if (!iniParams.openFile(paramsFile))
     {
-        string msg = "Error opening ini file: ";
-        msg += paramsFile;
-        throw std::runtime_error(msg);
+        string msg = "Error opening ini file: ";
+        msg += paramsFile;
+        throw std::runtime_error(msg);
+    }
+
+    cout << "Loaded parameters file: " << paramsFile << endl;
+}
+
+/**
+ * @brief Runs the cs471 lab 5 experiment, which involves executing
+ * the NEH algorithm for each flowshop objective function that
+ * is specified in the input parameters file. Every (input file, variant)
+ * pair is scheduled on one shared thread pool, and each input file is
+ * loaded only once for all variants.
+ * 
+ * @return int Returns a non-zero error code on failure. Otherwise returns zero.
+ */
+int Experiment::runNEH()
+{
+    // Retrieve test parameters for every variant from ini file
+    vector<TestParams> variants = readAllTestParams();
+
+    // Data tables that store experiment results, one per variant
+    vector<unique_ptr<mdata::DataTable<string>>> resultsTables;
+
+    return runBatch(variants, resultsTables);
+}
+
+/**
+ * @brief Reruns the experiment and checks its results against the golden results
+ * and the timing baseline of every variant. If any variant has a baseline, the
+ * batch is run timeRepetitions times and each data set's time is the median of
+ * the runs. Missing golden or baseline files are created from this run, so the
+ * first run of a new configuration records them.
+ * 
+ * @return Returns VERIFY_PASSED if every check passed, VERIFY_QUALITY_FAILED on a
+ * quality regression, VERIFY_TIME_FAILED on a speed regression, or the error code
+ * of the run if it failed.
+ */
+int Experiment::runVerify()
+{
+    vector<TestParams> variants = readAllTestParams();
+    vector<unique_ptr<mdata::DataTable<string>>> resultsTables;
+
+    // Read the golden results before the run, in case it writes over them
+    vector<unique_ptr<ResultSet>> goldens;
+
+    for (auto& p : variants)
+    {
+        if (p.goldenFile.empty())
+            throw std::runtime_error("Error: No goldenFile set for " + p.name);
+
+        ifstream golden(p.goldenFile);
+        goldens.emplace_back(golden.good() ? new ResultSet(ResultsVerifier::readCsv(p.goldenFile)) : nullptr);
+
+        // Only the data sets in the tested range are expected in the run
+        if (goldens.back() != nullptr)
+        {
+            ResultSet& g = *goldens.back();
+            g.erase(g.begin(), g.lower_bound(p.minTestFile));
+            g.erase(g.upper_bound(p.maxTestFile), g.end());
+        }
+    }
+
+    // Repeat the batch for timing, single data set times are too noisy to compare
+    int repetitions = 1;
+    for (auto& p : variants)
+    {
+        if (!p.baselineFile.empty())
+            repetitions = std::max(repetitions, p.verify.timeRepetitions);
+    }
+
+    // A resumed run would skip the data sets of the earlier repetitions
+    if (repetitions > 1)
+    {
+        for (auto& p : variants)
+        {
+            p.journalFile.clear();
+            p.resume = false;
+        }
+    }
+
+    vector<map<int, vector<double>>> times(variants.size());
+
+    for (int r = 0; r < repetitions; r++)
+    {
+        if (repetitions > 1)
+        {
+            cout << "=======================================" << endl;
+            cout << "Verify run " << r + 1 << " of " << repetitions << endl;
+        }
+
+        vector<unique_ptr<mdata::DataTable<string>>> runTables;
+
+        int err = runBatch(variants, runTables);
+        if (err) return err;
+
+        for (size_t v = 0; v < variants.size(); v++)
+        {
+            for (auto& res : tableResults(*runTables[v], variants[v]))
+                times[v][res.first].push_back(res.second.timeMs);
+        }
+
+        // Quality is checked on the first run
+        if (r == 0) resultsTables = std::move(runTables);
+    }
+
+    // Replace the times of the first run with the medians, so recorded baselines use them too
+    for (size_t v = 0; v < variants.size(); v++)
+    {
+        for (auto& t : times[v])
+        {
+            std::sort(t.second.begin(), t.second.end());
+            resultsTables[v]->setEntry(t.first - variants[v].minTestFile, 4, std::to_string(percentile(t.second, 50)));
+        }
+    }
+
+    bool qualityOk = true;
+    bool timeOk = true;
+
+    cout << "=======================================" << endl;
+
+    for (size_t v = 0; v < variants.size(); v++)
+    {
+        TestParams& p = variants[v];
+        ResultsVerifier verifier(p.name, p.verify, cout);
+        ResultSet actual = tableResults(*resultsTables[v], p);
+
+        if (goldens[v] != nullptr)
+        {
+            qualityOk &= verifier.checkQuality(*goldens[v], actual);
+        }
+        else
+        {
+            if (!resultsTables[v]->exportCSV(p.goldenFile.c_str(), p.fsyncPolicy))
+                throw std::runtime_error("Error: Unable to write golden results: " + p.goldenFile);
+
+            cout << p.name << ": no golden results, recorded them to: " << p.goldenFile << endl;
+        }
+
+        if (p.baselineFile.empty()) continue;
+
+        ifstream baseline(p.baselineFile);
+        if (baseline.good())
+        {
+            timeOk &= verifier.checkTime(ResultsVerifier::readCsv(p.baselineFile), actual);
+        }
+        else
+        {
+            if (!resultsTables[v]->exportCSV(p.baselineFile.c_str(), p.fsyncPolicy))
+                throw std::runtime_error("Error: Unable to write timing baseline: " + p.baselineFile);
+
+            cout << p.name << ": no timing baseline, recorded it to: " << p.baselineFile << endl;
+        }
+    }
+
+    if (!qualityOk)
+    {
+        cerr << "Verification failed: solution quality regressed." << endl;
+        return VERIFY_QUALITY_FAILED;
+    }
+
+    if (!timeOk)
+    {
+        cerr << "Verification failed: execution time regressed." << endl;
+        return VERIFY_TIME_FAILED;
+    }
+
+    cout << "Verification passed." << endl;
+    return VERIFY_PASSED;
+}
+
+/**
+ * @brief Reruns the experiment once per thread count and reports how the batch scales.
+ * Every run schedules the same tasks, with the pool sized to the thread count. For each
+ * thread count, the median wall time of the repetitions, the speedup and parallel
+ * efficiency relative to the first thread count, and the distribution of the NEH
+ * execution times of all data sets are written to [reportPrefix].csv and
+ * [reportPrefix].jsonl. Checkpoint journals are not used by scaling runs.
+ * 
+ * @param threadCounts Thread counts to run, the first one is the baseline
+ * @param repetitions Number of runs per thread count
+ * @param reportPrefix File path prefix of the report files
+ * @return int Returns a non-zero error code on failure. Otherwise returns zero.
+ */
+int Experiment::runScaling(const vector<int>& threadCounts, int repetitions, const string& reportPrefix)
+{
+    mdata::DataTable<string> report(threadCounts.size(), 10);
+    report.setColLabel(0, "Threads");
+    report.setColLabel(1, "Wall Time (ms)");
+    report.setColLabel(2, "Speedup");
+    report.setColLabel(3, "Efficiency");
+    report.setColLabel(4, "Tasks");
+    report.setColLabel(5, "Latency Mean (ms)");
+    report.setColLabel(6, "Latency p50 (ms)");
+    report.setColLabel(7, "Latency p90 (ms)");
+    report.setColLabel(8, "Latency p99 (ms)");
+    report.setColLabel(9, "Latency Max (ms)");
+
+    JsonlWriter json;
+    const string jsonFile = reportPrefix + ".jsonl";
+    if (!json.open(jsonFile.c_str()))
+        throw std::runtime_error("Error: Unable to open scaling report: " + jsonFile);
+
+    double baseWallMs = 0.0;
+
+    for (size_t t = 0; t < threadCounts.size(); t++)
+    {
+        const int threads = threadCounts[t];
+        vector<double> wallTimes;
+        vector<double> latencies;
+
+        for (int r = 0; r < repetitions; r++)
+        {
+            cout << "=======================================" << endl;
+            cout << "Scaling run with " << threads << " threads (" << r + 1 << " of " << repetitions << ")" << endl;
+
+            vector<TestParams> variants = readAllTestParams();
+            for (auto& p : variants)
+            {
+                p.numThreads = threads;
+                p.journalFile.clear();
+                p.resume = false;
+            }
+
+            vector<unique_ptr<mdata::DataTable<string>>> resultsTables;
+            PhaseClock clock;
+
+            int err = runBatch(variants, resultsTables);
+            if (err) return err;
+
+            wallTimes.push_back(clock.elapsed().wallMs);
+
+            for (size_t v = 0; v < variants.size(); v++)
+            {
+                for (auto& res : tableResults(*resultsTables[v], variants[v]))
+                    latencies.push_back(res.second.timeMs);
+            }
+        }
+
+        std::sort(wallTimes.begin(), wallTimes.end());
+        std::sort(latencies.begin(), latencies.end());
+
+        const double wallMs = percentile(wallTimes, 50);
+        if (t == 0) baseWallMs = wallMs;
+
+        const double speedup = wallMs > 0.0 ? baseWallMs / wallMs : 0.0;
+        const double efficiency = speedup * threadCounts.front() / threads;
+
+        double latencySum = 0.0;
+        for (double l : latencies) latencySum += l;
+        const double latencyMean = latencies.empty() ? 0.0 : latencySum / latencies.size();
+        const size_t tasks = latencies.size() / repetitions;
+
+        report.setEntry(t, 0, std::to_string(threads));
+        report.setEntry(t, 1, std::to_string(wallMs));
+        report.setEntry(t, 2, std::to_string(speedup));
+        report.setEntry(t, 3, std::to_string(efficiency));
+        report.setEntry(t, 4, std::to_string(tasks));
+        report.setEntry(t, 5, std::to_string(latencyMean));
+        report.setEntry(t, 6, std::to_string(percentile(latencies, 50)));
+        report.setEntry(t, 7, std::to_string(percentile(latencies, 90)));
+        report.setEntry(t, 8, std::to_string(percentile(latencies, 99)));
+        report.setEntry(t, 9, std::to_string(percentile(latencies, 100)));
+
+        JsonRecord rec;
+        rec.field("threads", threads).field("repetitions", repetitions).field("wallMs", wallMs);
+        rec.field("speedup", speedup).field("efficiency", efficiency).field("tasks", static_cast<unsigned long long>(tasks));
+        rec.beginObject("latencyMs").field("mean", latencyMean).field("p50", percentile(latencies, 50))
+            .field("p90", percentile(latencies, 90)).field("p99", percentile(latencies, 99))
+            .field("max", percentile(latencies, 100)).endObject();
+        json.write(rec);
+    }
+
+    json.close();
+
+    const string csvFile = reportPrefix + ".csv";
+    if (!report.exportCSV(csvFile.c_str()))
+        throw std::runtime_error("Error: Unable to write scaling report: " + csvFile);
+
+    cout << "=======================================" << endl;
+    cout << "Threads  Wall (ms)  Speedup  Efficiency  Latency p50 / p99 (ms)" << endl;
+    cout << fixed << setprecision(2);
+
+    for (size_t t = 0; t < threadCounts.size(); t++)
+    {
+        cout << setw(7) << threadCounts[t] << "  " << setw(9) << std::stod(report.getEntry(t, 1))
+             << "  " << setw(7) << std::stod(report.getEntry(t, 2)) << "  " << setw(10) << std::stod(report.getEntry(t, 3))
+             << "  " << std::stod(report.getEntry(t, 6)) << " / " << std::stod(report.getEntry(t, 8)) << endl;
+    }
+
+    cout << defaultfloat << setprecision(6);
+    cout << "Scaling report written to: " << csvFile << " and " << jsonFile << endl;
+    return 0;
+}
+
+/**
+ * @brief Runs NEH for a set of flowshop variants on one shared thread pool
+ * and exports the results of each variant.
+ * 
+ * @param variants Test parameters of every variant
+ * @param resultsTables Out vector that receives the results table of each variant
+ * @return int Returns a non-zero error code on failure. Otherwise returns zero.
+ */
+int Experiment::runBatch(vector<TestParams>& variants, vector<unique_ptr<mdata::DataTable<string>>>& resultsTables)
+{
+    resultsTables.clear();
+
+    int numThreads = 1;
+    int minTestFile = variants.front().minTestFile;
+    int maxTestFile = variants.front().maxTestFile;
+
+    for (auto& p : variants)
+    {
+        auto table = new mdata::DataTable<string>(p.maxTestFile - p.minTestFile + 1, resultsCols(p));
+
+        // Prepare results table column header labels
+        table->setColLabel(0, "Data Set");
+        table->setColLabel(1, "cMax");
+        table->setColLabel(2, "TFT");
+        table->setColLabel(3, "Func Calls");
+        table->setColLabel(4, "Execution Time (ms)");
+        table->setColLabel(5, "Arena Allocs");
+        table->setColLabel(6, "Arena Bytes");
+        table->setColLabel(7, "Load (ms)");
+        table->setColLabel(8, "Sort (ms)");
+        table->setColLabel(9, "Insertion (ms)");
+        table->setColLabel(10, "Evaluation (ms)");
+        table->setColLabel(11, "Output (ms)");
+        table->setColLabel(12, "Memory Estimate (KB)");
+        table->setColLabel(13, "Admission Wait (ms)");
+        table->setColLabel(14, "RSS Delta (KB)");
+
+        // Due date, hardware counter and allocation columns go before the sequence, which is always last
+        size_t col = RESULTS_COLS - 1;
+
+        if (usesDueDates(p))
+        {
+            table->setColLabel(col++, "Total Tardiness");
+            table->setColLabel(col++, "Weighted Tardiness");
+            table->setColLabel(col++, "Max Lateness");
+        }
+
+        if (p.perfCounters)
+        {
+            static const char* perfLabels[util::PERF_EVENT_COUNT] = { "Cycles", "Instructions", "L1D Misses", "LLC Misses", "Branch Misses" };
+            for (size_t e = 0; e < util::PERF_EVENT_COUNT; e++)
+                table->setColLabel(col++, perfLabels[e]);
+        }
+
+        if (util::allocTrackingEnabled())
+        {
+            table->setColLabel(col++, "Allocs");
+            table->setColLabel(col++, "Frees");
+            table->setColLabel(col++, "Alloc Bytes");
+            table->setColLabel(col++, "Peak Live Bytes");
+        }
+
+        table->setColLabel(resultsCols(p) - 1, "Sequence");
+
+        resultsTables.emplace_back(table);
+
+        if (p.numThreads > numThreads) numThreads = p.numThreads;
+        if (p.minTestFile < minTestFile) minTestFile = p.minTestFile;
+        if (p.maxTestFile > maxTestFile) maxTestFile = p.maxTestFile;
+    }
+
+    // Open every checkpoint journal once, variants may share one. When
+    // resuming, the entries already in a journal are read back first.
+    map<string, vector<string>> journalEntries;
+
+    for (auto& p : variants)
+    {
+        if (p.journalFile.empty() || journals.find(p.journalFile) != journals.end())
+            continue;
+
+        if (p.resume)
+        {
+            auto entries = Journal::load(p.journalFile.c_str());
+            journalEntries.insert(entries.begin(), entries.end());
+        }
+
+        unique_ptr<Journal> journal(new Journal());
+        if (!journal->open(p.journalFile.c_str(), p.resume, p.fsyncPolicy))
+            throw std::runtime_error("Error: Unable to open checkpoint journal: " + p.journalFile);
+
+        journals[p.journalFile] = std::move(journal);
+    }
+
+    // Restore the results of every task completed by a previous run,
+    // those tasks are not scheduled again
+    set<string> restoredTasks;
+
+    for (size_t v = 0; v < variants.size(); v++)
+    {
+        TestParams& p = variants[v];
+        if (!p.resume || p.journalFile.empty()) continue;
+
+        for (int i = p.minTestFile; i <= p.maxTestFile; i++)
+        {
+            auto entry = journalEntries.find(journalKey(p, i));
+            if (entry == journalEntries.end() || entry->second.size() != resultsCols(p))
+                continue;
+
+            for (size_t c = 0; c < entry->second.size(); c++)
+                resultsTables[v]->setEntry(i - p.minTestFile, c, entry->second[c]);
+
+            restoredTasks.insert(entry->first);
+        }
+    }
+
+    if (!restoredTasks.empty())
+        cout << "Resuming: restored " << restoredTasks.size() << " completed tasks from checkpoint journal" << endl;
+
+    // Check once that hardware counters can be read, tasks run without them otherwise
+    for (auto& p : variants)
+    {
+        if (!p.perfCounters) continue;
+
+        util::PerfCounters probe;
+        if (!probe.open())
+            cout << "Warning: Hardware performance counters are unavailable (" << probe.getError() << "). Counter columns will be empty." << endl;
+        else if (!probe.getError().empty())
+            cout << "Warning: Some hardware performance counters are unavailable (" << probe.getError() << ")." << endl;
+
+        break;
+    }
+
+    // Map every instance pack used by any variant once, up front
+    map<string, shared_ptr<InstancePack>> packs;
+
+    for (auto& p : variants)
+    {
+        if (InstancePack::isPackFile(p.inputFilesDir) && packs.find(p.inputFilesDir) == packs.end())
+        {
+            packs[p.inputFilesDir] = InstancePack::open(p.inputFilesDir.c_str());
+            cout << "Mapped instance pack: " << p.inputFilesDir << endl;
+        }
+    }
+
+    // Create one shared instance slot per input file, and count
+    // how many variants will run on it
+    map<string, SharedInstance> sharedInstances;
+
+    for (int i = minTestFile; i <= maxTestFile; i++)
+    {
+        for (auto& p : variants)
+        {
+            if (i < p.minTestFile || i > p.maxTestFile) continue;
+            if (restoredTasks.count(journalKey(p, i))) continue;
+
+            string name = inputName(p.inputFilesDir, i);
+            SharedInstance& shared = sharedInstances[name];
+            shared.inputFile = name;
+            shared.testIndex = i;
+            shared.pendingTasks += 1;
+
+            auto pack = packs.find(p.inputFilesDir);
+            if (pack != packs.end())
+                shared.pack = pack->second;
+        }
+    }
+
+    // Estimate the memory of every instance from its size, without loading it
+    const double maxMemoryMB = iniParams.getEntryAs<double>(INI_TEST_SECTION, INI_TEST_MAXMEMORYMB, 0.0);
+    memoryBudget.setLimit(maxMemoryMB > 0.0 ? static_cast<size_t>(maxMemoryMB * 1024.0 * 1024.0) : 0);
+    memoryBudget.resetStats();
+    size_t oversized = 0;
+
+    for (auto& entry : sharedInstances)
+    {
+        SharedInstance& shared = entry.second;
+        readInstanceSize(shared);
+        shared.instanceBytes.bytes = Instance::estimateBytes(shared.machines, shared.jobs);
+
+        if (maxMemoryMB > 0.0 && shared.instanceBytes.bytes + NEH::estimateBytes(shared.machines, shared.jobs) > memoryBudget.getLimit())
+            oversized++;
+    }
+
+    // The cache limit below only applies to this batch
+    ScopedCacheCapacity cacheCapacity(InstanceCache::global());
+
+    if (maxMemoryMB > 0.0)
+    {
+        // Instances kept in the cache after their tasks finish are outside the
+        // budget, so only keep as many as there can be tasks running
+        InstanceCache::global().setCapacity(static_cast<size_t>(numThreads));
+        cout << "Memory budget: " << maxMemoryMB << " MB" << endl;
+
+        if (oversized > 0)
+            cout << "Warning: " << oversized << " data sets are estimated to need more than maxMemoryMB, they will run alone." << endl;
     }
 
-    cout << "Loaded parameters file: " << paramsFile << endl;
-}
+    // Open every JSON-lines results stream once, variants may share one
+    for (auto& p : variants)
+    {
+        if (p.jsonlFile.empty() || jsonlWriters.find(p.jsonlFile) != jsonlWriters.end())
+            continue;
 
-/**
- * @brief Runs the cs471 lab 5 experiment, which involves executing
- * the NEH algorithm for a specific flowshop objective function that
- * is specified in the input parameters file.
- * 
- * @return int Returns a non-zero error code on failure. Otherwise returns zero.
- */
-int Experiment::runNEH()
-{
-    // Retrieve test parameters from ini file
-    TestParams p = readTestParams();
+        unique_ptr<JsonlWriter> writer(new JsonlWriter());
+        if (!writer->open(p.jsonlFile.c_str(), p.fsyncPolicy, p.resume))
+            throw std::runtime_error("Error: Unable to open JSON-lines results file: " + p.jsonlFile);
 
-    // Construct data table to store experiment results
-    mdata::DataTable<string> resultsTable(p.maxTestFile - p.minTestFile + 1, 6);
+        jsonlWriters[p.jsonlFile] = std::move(writer);
+    }
+
+    // Start recording a timeline of the batch if a trace file is set. Tracing
+    // is batch wide, so it is only read from the [test] section.
+    const string traceFile = iniParams.getEntry(INI_TEST_SECTION, INI_TEST_TRACEFILE, "");
+    if (!traceFile.empty())
+    {
+        Tracer::global().start(iniParams.getEntryAs<size_t>(INI_TEST_SECTION, INI_TEST_TRACEEVENTS, 1 << 17),
+            iniParams.getEntryAs<unsigned int>(INI_TEST_SECTION, INI_TEST_TRACESAMPLING, 1));
+        Tracer::global().nameThread("main");
+    }
+
+    // Initialize a single writer thread for time matrix and Gantt files, so
+    // file output overlaps with the solver threads. It is declared before the
+    // solver pool so it is joined last, after all output has been queued.
+    ThreadPool outputPool(1);
 
     // Initialize thread pool with a parameter-given number of threads
-    ThreadPool tpool(p.numThreads);
+    ThreadPool tpool(numThreads);
+
+    // Print the worker, queue latency and lock wait counters of both pools once joined
+    tpool.setStatsOutput(&cout, "solver");
+    outputPool.setStatsOutput(&cout, "output");
 
     // Initialize thread future vector, used for thread pool synchronization
     // and keeps track of the individual tasks being executed.
     vector<std::future<int>> futures;
 
-    cout << "Started " << p.numThreads << " worker threads ..." << endl;
+    // Description of each task, used for the failure summary
+    vector<string> taskNames;
 
-    if (p.algorithm == 1)
-        cout << "Running NEH on Flow Shop with Blocking ..." << endl;
-    else if (p.algorithm == 2)
-        cout << "Running NEH on Flow Shop with No Wait ..." << endl;
-    else
-        cout << "Running NEH on Flow Shop Scheduling ..." << endl;
+    cout << "Started " << numThreads << " worker threads ..." << endl;
+
+    for (auto& p : variants)
+    {
+        cout << "Running NEH on " << algorithmName(p.algorithm);
+        if (p.objective != OBJ_CMAX)
+            cout << " minimizing " << objectiveTypeName(p.objective);
+        cout << " ..." << endl;
+    }
 
-    // Prepare results table column header labels
-    resultsTable.setColLabel(0, "Data Set");
-    resultsTable.setColLabel(1, "cMax");
-    resultsTable.setColLabel(2, "TFT");
-    resultsTable.setColLabel(3, "Func Calls");
-    resultsTable.setColLabel(4, "Execution Time (ms)");
-    resultsTable.setColLabel(5, "Sequence");
+    cancelToken.reset();
+    threadPhases.clear();
 
-    // Add all input test files as tasks in thread pool
-    for (int i = p.minTestFile; i <= p.maxTestFile; i++)
+    // Add all (input file, variant) pairs as tasks in thread pool. Variants
+    // of the same input file are queued next to each other so the instance
+    // is released soon after it is loaded.
+    for (int i = minTestFile; i <= maxTestFile; i++)
+    {
+        for (size_t v = 0; v < variants.size(); v++)
+        {
+            TestParams* p = &variants[v];
+            if (i < p->minTestFile || i > p->maxTestFile) continue;
+            if (restoredTasks.count(journalKey(*p, i))) continue;
+
+            SharedInstance* shared = &sharedInstances[inputName(p->inputFilesDir, i)];
+            futures.emplace_back(
+                tpool.enqueue(&cs471::Experiment::runNEHThreaded, this, p, shared, i, resultsTables[v].get(), &outputPool)
+            );
+            taskNames.push_back(p->name + " " + shared->inputFile);
+        }
+    }
+
+    // Poll all thread pool tasks in the order they complete. The first
+    // failing task cancels the batch, so every remaining task either
+    // stops at its next NEH step or is skipped when it is dequeued.
+    int firstErr = 0;
+    size_t numCompleted = 0;
+    size_t numSkipped = 0;
+    vector<string> failedTasks;
+    vector<size_t> pending;
+
+    for (size_t i = 0; i < futures.size(); i++)
+        pending.push_back(i);
+
+    while (!pending.empty())
+    {
+        // Wait briefly on the oldest task, then collect every finished task
+        futures[pending.front()].wait_for(milliseconds(10));
+
+        for (size_t k = 0; k < pending.size(); )
+        {
+            size_t i = pending[k];
+            if (futures[i].wait_for(seconds(0)) != future_status::ready)
+            {
+                k++;
+                continue;
+            }
+
+            int err = futures[i].get();
+            if (err == TASK_OK)
+            {
+                numCompleted++;
+            }
+            else if (err == TASK_SKIPPED)
+            {
+                numSkipped++;
+            }
+            else
+            {
+                failedTasks.push_back(taskNames[i]);
+                if (firstErr == 0) firstErr = err;
+                cancelToken.cancel();
+            }
+
+            pending[k] = pending.back();
+            pending.pop_back();
+        }
+    }
+
+    if (firstErr)
     {
-        string inputFile = std::to_string(i) + ".txt";
-        futures.emplace_back(
-            tpool.enqueue(&cs471::Experiment::runNEHThreaded, this, &p, inputFile, i, &resultsTable)
-        );
+        // At least one task failed, print summary and bail
+        cerr << "Batch cancelled: " << failedTasks.size() << " failed, " << numSkipped
+             << " skipped, " << numCompleted << " completed." << endl;
+
+        for (auto& name : failedTasks)
+            cerr << "Failed: " << name << endl;
+
+        tpool.stopAndJoinAll();
+        outputPool.stopAndJoinAll();
+        printThreadPhases();
+        printMemorySummary();
+        writeTrace(traceFile);
+        jsonlWriters.clear();
+        journals.clear();
+        return firstErr;
     }
 
-    // const size_t totalFutures = futures.size();
+    // Wait for the remaining solution output, which fills in the output time
+    // column and journals its task once written
+    tpool.stopAndJoinAll();
+    outputPool.stopAndJoinAll();
+    printThreadPhases();
+    printMemorySummary();
+    writeTrace(traceFile);
 
-    // Join all thread pool tasks using futures vector
-    // and get the return value for each
-    for (int i = 0; i < futures.size(); i++)
+    // Output results tables to csv files
+    for (size_t v = 0; v < variants.size(); v++)
     {
-        int err = futures[i].get();
-        if (err)
+        if (!variants[v].resultsFile.empty())
         {
-            // Threaded task returned with an error code, bail
-            tpool.stopAndJoinAll();
-            return err;
+            resultsTables[v]->exportCSV(variants[v].resultsFile.c_str(), variants[v].fsyncPolicy);
+            cout << "Results exported to: " << variants[v].resultsFile << endl;
         }
     }
 
-    // Output results table to a csv file
-    if (!p.resultsFile.empty())
+    // Close JSON-lines results streams
+    for (auto& writer : jsonlWriters)
+    {
+        if (writer.second->close())
+            cout << "Results streamed to: " << writer.first << endl;
+    }
+
+    jsonlWriters.clear();
+
+    // Close checkpoint journals
+    for (auto& journal : journals)
     {
-        resultsTable.exportCSV(p.resultsFile.c_str());
-        cout << "Results exported to: " << p.resultsFile << endl;
+        if (!journal.second->close())
+            cerr << "Warning: Unable to write checkpoint journal: " << journal.first << endl;
     }
 
+    journals.clear();
     return 0;
 }
 
@@ -131,172 +989,720 @@ int Experiment::runNEH()
  * @brief Runs a single instance of the NEH algorithm.
  * This function should only be executed from within an async thread.
  * 
- * @param p Pointer to the experiment test parameters
- * @param inputFile Input file containing the job processing time matrix
+ * @param p Pointer to the experiment test parameters of the variant being run
+ * @param shared Pointer to the shared input file slot containing the job processing time matrix
  * @param testIndex Index of the input test file, used to store results in results table on correct row
  * @param resultsTable Pointer to the results table which this function will place it's NEH results into
+ * @param outputPool Writer thread that time matrix and Gantt files are handed off to
  * @return int 
  */
-int Experiment::runNEHThreaded(TestParams* const p, const std::string inputFile, int testIndex, mdata::DataTable<std::string>* resultsTable)
+int Experiment::runNEHThreaded(TestParams* const p, SharedInstance* shared, int testIndex, mdata::DataTable<std::string>* resultsTable, ThreadPool* outputPool)
 {
-    string fullInputPath = p->inputFilesDir + inputFile;
+    Tracer::global().nameThread("solver");
+    FSHOP_TRACE_ARGS("task", "batch", "dataSet", testIndex, "algorithm", p->algorithm);
+
+    // Skip the task entirely if the batch has been cancelled
+    if (cancelToken.isCancelled())
+    {
+        releaseInstance(shared);
+        return TASK_SKIPPED;
+    }
+
+    // Wait until the estimated memory of the task, and of its instance if no
+    // other variant holds it yet, fits in the memory budget. The time matrices
+    // of the solution are held until the writer thread has written them.
+    const bool hasOutput = !p->timesFile.empty() || !p->ganttDir.empty();
+    const size_t outputBytes = hasOutput ? 2 * shared->machines * shared->jobs * sizeof(int) : 0;
+    const size_t setupBytes = p->algorithm == 3 ? SetupTimes::estimateBytes(shared->machines, shared->jobs) : 0;
+    const size_t taskBytes = NEH::estimateBytes(shared->machines, shared->jobs) + setupBytes + outputBytes;
+    double admissionWaitMs = 0.0;
+
+    if (!admitTask(shared, taskBytes, admissionWaitMs))
+    {
+        releaseInstance(shared);
+        return TASK_SKIPPED;
+    }
+
+    // Phase times of this task are the growth of this thread's totals
+    const util::PhaseTotals phasesBefore = util::threadPhaseTotals();
+
+    // Heap allocations of this task, with the peak measured from the current live bytes
+    util::resetThreadAllocPeak();
+    const util::AllocStats allocBefore = util::threadAllocStats();
+
+    // Resident size change of the process while this task runs
+    const size_t rssBefore = util::currentRssBytes();
+
+    // Get the shared instance, loading it if no other variant has yet.
+    // Setup times and due dates are small next to the NEH run, so each task loads its own.
+    util::PhaseClock loadClock;
+    InstancePtr instance;
+    SetupTimesPtr setups;
+    DueDatesPtr dueDates;
+    vector<int> bufferSizes;
+    {
+        FSHOP_TIME_PHASE(util::PHASE_LOAD);
+        FSHOP_TRACE_ARG("load", "io", "dataSet", testIndex);
+        instance = acquireInstance(shared);
+
+        try
+        {
+            if (instance != nullptr && p->algorithm == 3)
+                setups = loadSetupTimes(*p, testIndex);
+            if (instance != nullptr && p->algorithm == 4)
+                bufferSizes = loadBufferSizes(*p, testIndex);
+            if (instance != nullptr && usesDueDates(*p))
+                dueDates = loadDueDates(*p, testIndex);
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << e.what() << endl;
+            instance.reset();
+        }
+    }
+    util::PhaseTime loadTime = loadClock.elapsed();
+    if (instance == nullptr)
+    {
+        cancelToken.cancel();
+        memoryBudget.release(taskBytes);
+        releaseInstance(shared);
+        return TASK_LOAD_ERROR;
+    }
 
     // Get the flowshop objective function that we want to optimize
-    auto objectiveFs = allocFlowShop(fullInputPath.c_str(), p->algorithm);
+    FlowshopBasic* objectiveFs = nullptr;
+    try
+    {
+        objectiveFs = allocFlowShop(instance, p->algorithm, setups, bufferSizes);
+        objectiveFs->setDueDates(dueDates);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << endl;
+    }
+
+    instance.reset();
+    setups.reset();
+    dueDates.reset();
+
     if (objectiveFs == nullptr)
-        return 1;
+    {
+        cancelToken.cancel();
+        memoryBudget.release(taskBytes);
+        releaseInstance(shared);
+        return TASK_LOAD_ERROR;
+    }
 
     // Prepare pointer to results
     fsSol result = nullptr;
 
+    // Count arena usage for this instance only
+    util::Arena& arena = util::threadArena();
+    arena.resetCounters();
+
     // Start recording execution time
     high_resolution_clock::time_point t_start = high_resolution_clock::now();
+    util::PhaseClock nehClock;
+
+    // Count hardware events of the NEH run only
+    util::PerfCounters* perf = p->perfCounters ? &util::threadPerfCounters() : nullptr;
+    util::PerfSample perfSample;
 
     try
     {
         // Run the NEH algorithm on the objective flowshop function
-        NEH neh;
-        result = neh.run(objectiveFs);
+        FSHOP_TRACE_ARG("neh", "neh", "jobs", static_cast<int64_t>(objectiveFs->getTotalJobs()));
+        NEH neh(p->seed != 0 ? p->seed + static_cast<unsigned int>(testIndex) : 0, p->objective);
+        if (perf != nullptr) perf->start();
+        result = neh.run(objectiveFs, &cancelToken);
+        if (perf != nullptr) perfSample = perf->stop();
     }
     catch(const std::exception& e)
     {
         std::cerr << "An exception occurred while running NEH:" << endl;
         std::cerr << e.what() << endl;
-        std::cerr << "Input file: " << inputFile << endl;
-        return 2;
+        std::cerr << "Input file: " << shared->inputFile << endl;
+        cancelToken.cancel();
+        delete objectiveFs;
+        memoryBudget.release(taskBytes);
+        releaseInstance(shared);
+        return TASK_NEH_ERROR;
+    }
+
+    // NEH stopped early because the batch was cancelled
+    if (result == nullptr)
+    {
+        delete objectiveFs;
+        memoryBudget.release(taskBytes);
+        releaseInstance(shared);
+        return TASK_SKIPPED;
     }
     
     // Record execution time
+    util::PhaseTime nehTime = nehClock.elapsed();
     high_resolution_clock::time_point t_end = high_resolution_clock::now();
     double execTimeMs = static_cast<double>(duration_cast<nanoseconds>(t_end - t_start).count()) / 1000000.0;
+    const util::PhaseTotals phases = util::threadPhaseTotals().since(phasesBefore);
+    recordThreadPhases(phases);
+
+    const long long rssDeltaBytes = static_cast<long long>(util::currentRssBytes()) - static_cast<long long>(rssBefore);
 
     // Insert NEH results into results table at the correct row
-    resultsTable->setEntry(testIndex, 0, std::to_string(testIndex));
-    resultsTable->setEntry(testIndex, 1, std::to_string(result->cmax));
-    resultsTable->setEntry(testIndex, 2, std::to_string(result->totalFlowTime));
-    resultsTable->setEntry(testIndex, 3, std::to_string(objectiveFs->getFuncCallCounts()));
-    resultsTable->setEntry(testIndex, 4, std::to_string(execTimeMs));
-    resultsTable->setEntry(testIndex, 5, result->getJobSeqAsString());
-
-
-    // ======= GANTT STUFF =======
-    /*
-    const size_t numMachines = objectiveFs->getTotalMachines();
-    const size_t numJobs = objectiveFs->getTotalJobs();
-    
-    auto startTimeMatrix = result->getStartTimeMatrix();
-    auto departTimeMatrix = result->getDepartTimeMatrix();
+    vector<string> row = {
+        std::to_string(testIndex),
+        std::to_string(result->cmax),
+        std::to_string(result->totalFlowTime),
+        std::to_string(objectiveFs->getFuncCallCounts()),
+        std::to_string(execTimeMs),
+        std::to_string(arena.getAllocsServed()),
+        std::to_string(arena.getBytesServed()),
+        std::to_string(phases.getMs(util::PHASE_LOAD)),
+        std::to_string(phases.getMs(util::PHASE_SORT)),
+        std::to_string(phases.getMs(util::PHASE_INSERTION)),
+        std::to_string(phases.getMs(util::PHASE_EVALUATION)),
+        "0",
+        std::to_string((taskBytes + shared->instanceBytes.bytes) / 1024),
+        std::to_string(admissionWaitMs),
+        std::to_string(rssDeltaBytes / 1024)
+    };
+
+    if (usesDueDates(*p))
+    {
+        row.push_back(std::to_string(result->value.totalTardiness));
+        row.push_back(std::to_string(result->value.weightedTardiness));
+        row.push_back(std::to_string(result->value.maxLateness));
+    }
+
+    if (p->perfCounters)
+    {
+        for (size_t e = 0; e < util::PERF_EVENT_COUNT; e++)
+        {
+            const util::PerfEvent ev = static_cast<util::PerfEvent>(e);
+            row.push_back(perfSample.has(ev) ? std::to_string(perfSample.get(ev)) : "");
+        }
+    }
 
-    mdata::DataTable<std::string> ganttTable(numJobs * numMachines, 5);
+    const util::AllocStats allocs = util::threadAllocStats().since(allocBefore);
+    if (util::allocTrackingEnabled())
+    {
+        row.push_back(std::to_string(allocs.allocs));
+        row.push_back(std::to_string(allocs.frees));
+        row.push_back(std::to_string(allocs.bytes));
+        row.push_back(std::to_string(allocs.peakLiveBytes));
+    }
 
-    ganttTable.setColLabel(0, "Item");
-    ganttTable.setColLabel(1, "Machine");
-    ganttTable.setColLabel(2, "Job");
-    ganttTable.setColLabel(3, "Start");
-    ganttTable.setColLabel(4, "End");
+    row.push_back(result->getJobSeqAsString());
 
-    size_t row = 0;
+    for (size_t c = 0; c < row.size(); c++)
+        resultsTable->setEntry(testIndex - p->minTestFile, c, row[c]);
 
-    for (size_t m = 0; m < numMachines; m++)
+    // Stream the results record as soon as the instance completes
+    if (!p->jsonlFile.empty())
     {
-        for (size_t j = 0; j < numJobs; j++)
+        std::ostringstream threadId;
+        threadId << std::this_thread::get_id();
+
+        util::JsonRecord rec;
+        rec.field("variant", p->name)
+           .field("algorithm", algorithmName(p->algorithm))
+           .field("dataSet", testIndex)
+           .field("input", shared->inputFile)
+           .field("jobs", objectiveFs->getTotalJobs())
+           .field("machines", objectiveFs->getTotalMachines())
+           .field("cmax", result->cmax)
+           .field("tft", result->totalFlowTime)
+           .field("evaluations", objectiveFs->getFuncCallCounts())
+           .field("threadId", threadId.str());
+
+        if (usesDueDates(*p))
         {
-            ganttTable.setEntry(row, 0, std::to_string(row + 1));
-            ganttTable.setEntry(row, 1, std::string("Machine ") + std::to_string(m + 1));
-            ganttTable.setEntry(row, 2, std::string("Job ") + std::to_string(j + 1));
-            ganttTable.setEntry(row, 3, std::to_string(startTimeMatrix[m][j]));
-            ganttTable.setEntry(row, 4, std::to_string(departTimeMatrix[m][j]));
+            rec.beginObject("dueDates")
+               .field("objective", objectiveTypeName(p->objective))
+               .field("totalTardiness", result->value.totalTardiness)
+               .field("weightedTardiness", result->value.weightedTardiness)
+               .field("maxLateness", result->value.maxLateness)
+               .endObject();
+        }
+
+        rec.beginObject("phases");
+        rec.beginObject("load").field("wallMs", loadTime.wallMs).field("cpuMs", loadTime.cpuMs).endObject();
+        rec.beginObject("neh").field("wallMs", nehTime.wallMs).field("cpuMs", nehTime.cpuMs).endObject();
+        rec.endObject();
 
-            row++;
+        rec.beginObject("timersMs");
+        for (int ph = util::PHASE_LOAD; ph < util::PHASE_OUTPUT; ph++)
+            rec.field(util::phaseName(static_cast<util::TimedPhase>(ph)), phases.getMs(static_cast<util::TimedPhase>(ph)));
+        rec.endObject();
+
+        if (p->perfCounters)
+        {
+            rec.beginObject("perf");
+            for (size_t e = 0; e < util::PERF_EVENT_COUNT; e++)
+            {
+                const util::PerfEvent ev = static_cast<util::PerfEvent>(e);
+                if (perfSample.has(ev))
+                    rec.field(util::PerfCounters::eventName(ev), static_cast<unsigned long long>(perfSample.get(ev)));
+                else
+                    rec.field(util::PerfCounters::eventName(ev), nullptr);
+            }
+            rec.endObject();
         }
-    }
 
-    std::string ganttfile = "results/gantt/";
+        if (util::allocTrackingEnabled())
+        {
+            rec.beginObject("alloc")
+               .field("allocs", allocs.allocs)
+               .field("frees", allocs.frees)
+               .field("bytes", allocs.bytes)
+               .field("peakLiveBytes", allocs.peakLiveBytes);
+
+            for (int ph = util::PHASE_LOAD; ph < util::PHASE_OUTPUT; ph++)
+            {
+                rec.beginObject(util::phaseName(static_cast<util::TimedPhase>(ph)))
+                   .field("allocs", phases.allocs[ph])
+                   .field("bytes", phases.allocBytes[ph])
+                   .endObject();
+            }
 
-    if (p->algorithm == 0)
-        ganttfile += "fss/";
-    else if (p->algorithm == 1)
-        ganttfile += "fsb/";
-    else
-        ganttfile += "fsnw/";
+            rec.endObject();
+        }
 
-    ganttfile += std::to_string(testIndex);
-    ganttfile += "-gantt.csv";
-    ganttTable.exportCSV(ganttfile.c_str());
-    */
-    // ===========================
+        rec.beginObject("memory")
+           .field("estimateBytes", static_cast<unsigned long long>(taskBytes + shared->instanceBytes.bytes))
+           .field("admissionWaitMs", admissionWaitMs)
+           .field("rssDeltaBytes", rssDeltaBytes)
+           .endObject();
 
+        rec.field("arenaAllocs", arena.getAllocsServed())
+           .field("arenaBytes", arena.getBytesServed())
+           .field("sequence", result->getJobSeq(), result->seqSize);
 
-    // Dump NEH results start and departure time matrices to a csv file
-    if (!p->timesFile.empty())
-        result->outputTimesCsv(util::s_replace(p->timesFile, "%TEST%", std::to_string(testIndex)));
+        jsonlWriters.at(p->jsonlFile)->write(rec);
+    }
+
+    // Hand the solution off to the writer thread for time matrix and Gantt output.
+    // The task is journaled once all of its output has been written.
+    if (hasOutput)
+        outputPool->enqueue(&Experiment::outputSolution, this, p, testIndex, std::shared_ptr<FlowshopSolution>(std::move(result)), resultsTable, std::move(row), outputBytes);
+    else
+        journalResult(p, testIndex, row);
 
     // Clean up allocated memory
     delete objectiveFs;
+    memoryBudget.release(taskBytes - outputBytes);
+    releaseInstance(shared);
 
-    return 0;
+    return TASK_OK;
+}
+
+/**
+ * @brief Writes the time matrix and Gantt chart files of a single NEH solution,
+ * then records the output time and journals the task.
+ * This function runs on the output writer thread, after the solver thread has
+ * moved on to its next task.
+ * 
+ * @param p Pointer to the experiment test parameters of the variant that was run
+ * @param testIndex Index of the input test file the solution belongs to
+ * @param solution NEH solution to write out
+ * @param resultsTable Results table that receives the output phase time
+ * @param row Results table row of the solution, journaled after the output is written
+ * @param outputBytes Estimated bytes of the time matrices, released once they are written
+ */
+void Experiment::outputSolution(const TestParams* p, int testIndex, std::shared_ptr<FlowshopSolution> solution, mdata::DataTable<std::string>* resultsTable, std::vector<std::string> row, size_t outputBytes)
+{
+    Tracer::global().nameThread("output");
+
+    const util::PhaseTotals phasesBefore = util::threadPhaseTotals();
+    {
+        FSHOP_TIME_PHASE(util::PHASE_OUTPUT);
+        FSHOP_TRACE_ARG("output", "io", "dataSet", testIndex);
+        writeSolutionFiles(p, testIndex, *solution);
+    }
+
+    const util::PhaseTotals phases = util::threadPhaseTotals().since(phasesBefore);
+    recordThreadPhases(phases);
+
+    // The time matrices are released once written
+    solution.reset();
+    memoryBudget.release(outputBytes);
+
+    row[RESULTS_OUTPUT_COL] = std::to_string(phases.getMs(util::PHASE_OUTPUT));
+    resultsTable->setEntry(testIndex - p->minTestFile, RESULTS_OUTPUT_COL, row[RESULTS_OUTPUT_COL]);
+
+    journalResult(p, testIndex, row);
+}
+
+/**
+ * @brief Writes the time matrix and Gantt chart files of a single NEH solution
+ * 
+ * @param p Pointer to the experiment test parameters of the variant that was run
+ * @param testIndex Index of the input test file the solution belongs to
+ * @param solution NEH solution to write out
+ */
+void Experiment::writeSolutionFiles(const TestParams* p, int testIndex, FlowshopSolution& solution)
+{
+    // Dump start and departure time matrices to csv files or a binary file
+    if (!p->timesFile.empty())
+    {
+        const std::string timesPrefix = util::s_replace(p->timesFile, "%TEST%", std::to_string(testIndex));
+        bool success;
+
+        if (p->timesFormat == TIMES_BIN)
+            success = solution.outputTimesBin(timesPrefix + ".bin", p->timesCompress, p->fsyncPolicy);
+        else
+            success = solution.outputTimesCsv(timesPrefix, p->fsyncPolicy);
+
+        if (!success)
+            cerr << "Warning: Unable to write time matrices: " << timesPrefix << endl;
+    }
+
+    // Dump Gantt chart rows to [ganttDir]/[testIndex]-gantt.csv
+    if (!p->ganttDir.empty())
+    {
+        std::string ganttFile = p->ganttDir;
+        if (ganttFile.back() != '/' && ganttFile.back() != '\\')
+            ganttFile += '/';
+
+        ganttFile += std::to_string(testIndex) + "-gantt.csv";
+
+        if (!solution.outputGanttCsv(ganttFile, p->fsyncPolicy))
+            cerr << "Warning: Unable to write Gantt file: " << ganttFile << endl;
+    }
+}
+
+/**
+ * @brief Records a completed task in the variant's checkpoint journal, if it has one.
+ * A resumed run restores the task's results from this entry instead of running it again.
+ * 
+ * @param p Pointer to the experiment test parameters of the variant that was run
+ * @param testIndex Index of the input test file that was run
+ * @param row Results table row of the task
+ */
+void Experiment::journalResult(const TestParams* p, int testIndex, const std::vector<std::string>& row)
+{
+    if (p->journalFile.empty()) return;
+
+    if (!journals.at(p->journalFile)->write(journalKey(*p, testIndex), row))
+        cerr << "Warning: Unable to write checkpoint journal: " << p->journalFile << endl;
+}
+
+/**
+ * @brief Adds the phase times of a task to the totals of the calling thread
+ * 
+ * @param phases Phase times of the task
+ */
+void Experiment::recordThreadPhases(const util::PhaseTotals& phases)
+{
+    std::lock_guard<std::mutex> lock(threadPhasesLock);
+    threadPhases[std::this_thread::get_id()].add(phases);
+}
+
+/**
+ * @brief Prints the phase times of every thread that ran tasks in the last batch
+ */
+void Experiment::printThreadPhases()
+{
+#if !defined(FSHOP_NO_PHASE_TIMERS)
+    std::lock_guard<std::mutex> lock(threadPhasesLock);
+    if (threadPhases.empty()) return;
+
+    util::PhaseTotals total;
+    cout << "Phase times by thread (ms):" << endl;
+    cout << fixed << setprecision(2);
+
+    int n = 0;
+    for (auto& t : threadPhases)
+    {
+        cout << "  Thread " << n++ << ":";
+        for (int ph = 0; ph < util::PHASE_COUNT; ph++)
+            cout << " " << util::phaseName(static_cast<util::TimedPhase>(ph)) << "=" << t.second.getMs(static_cast<util::TimedPhase>(ph));
+        cout << endl;
+
+        total.add(t.second);
+    }
+
+    cout << "  Total:";
+    for (int ph = 0; ph < util::PHASE_COUNT; ph++)
+        cout << " " << util::phaseName(static_cast<util::TimedPhase>(ph)) << "=" << total.getMs(static_cast<util::TimedPhase>(ph));
+    cout << endl;
+
+    if (util::allocTrackingEnabled())
+    {
+        cout << "Heap allocations by phase, all threads:";
+        for (int ph = 0; ph < util::PHASE_COUNT; ph++)
+            cout << " " << util::phaseName(static_cast<util::TimedPhase>(ph)) << "=" << total.allocs[ph] << " (" << total.allocBytes[ph] << " bytes)";
+        cout << endl;
+    }
+
+    cout << defaultfloat << setprecision(6);
+#endif
+}
+
+/**
+ * @brief Stops tracing and writes the timeline of the batch, if tracing was started.
+ * Must be called after the thread pools are joined.
+ * 
+ * @param traceFile Path of the Chrome Trace Event file, or empty if tracing is off
+ */
+void Experiment::writeTrace(const std::string& traceFile)
+{
+    if (traceFile.empty()) return;
+
+    Tracer& tracer = Tracer::global();
+    tracer.stop();
+
+    if (!tracer.writeChromeTrace(traceFile.c_str()))
+    {
+        cerr << "Warning: Unable to write trace file: " << traceFile << endl;
+        return;
+    }
+
+    cout << "Trace written to: " << traceFile << endl;
+    if (tracer.getDropped() > 0)
+        cout << "Warning: " << tracer.getDropped() << " trace events were overwritten, raise traceEventsPerThread or traceStepSampling." << endl;
+}
+
+/**
+ * @brief Returns the instance for a shared input file, loading it
+ * if this is the first task to request it.
+ * 
+ * @param shared Pointer to the shared input file slot
+ * @return Returns the loaded instance, or nullptr if the file could not be loaded
+ */
+InstancePtr Experiment::acquireInstance(SharedInstance* shared)
+{
+    std::lock_guard<std::mutex> lock(shared->lock);
+
+    if (shared->instance == nullptr && !shared->loadFailed)
+    {
+        try
+        {
+            if (shared->pack != nullptr)
+                shared->instance = shared->pack->getInstance(shared->testIndex);
+            else
+                shared->instance = InstanceCache::global().get(shared->inputFile);
+        }
+        catch(const std::exception& e)
+        {
+            std::cerr << e.what() << endl;
+            shared->loadFailed = true;
+        }
+    }
+
+    return shared->instance;
+}
+
+/**
+ * @brief Signals that a task has finished with a shared input file.
+ * The instance is released once every scheduled task is done with it.
+ * 
+ * @param shared Pointer to the shared input file slot
+ */
+void Experiment::releaseInstance(SharedInstance* shared)
+{
+    std::lock_guard<std::mutex> lock(shared->lock);
+
+    shared->pendingTasks -= 1;
+    if (shared->pendingTasks <= 0)
+    {
+        shared->instance.reset();
+        memoryBudget.releaseShared(shared->instanceBytes);
+    }
+}
+
+/**
+ * @brief Waits until a task fits in the memory budget and holds its estimated bytes.
+ * The first task admitted for a shared input file also holds the bytes of its instance,
+ * which are released by releaseInstance() once the last task of the file is done.
+ * The instance does not keep the other variants of an oversized file from running alone.
+ * 
+ * @param shared Pointer to the shared input file slot of the task
+ * @param taskBytes Estimated bytes of the task, without the instance
+ * @param waitMs Out reference that receives the time spent waiting, in milliseconds
+ * @return Returns true if the task was admitted, or false if the batch was cancelled while waiting
+ */
+bool Experiment::admitTask(SharedInstance* shared, size_t taskBytes, double& waitMs)
+{
+    return memoryBudget.acquire(taskBytes, &cancelToken, &waitMs, &shared->instanceBytes);
+}
+
+/**
+ * @brief Prints the peak resident memory of the process, and the peak estimated
+ * memory and admission delays of the batch
+ */
+void Experiment::printMemorySummary()
+{
+    cout << fixed << setprecision(2);
+    cout << "Memory: process peak RSS " << util::peakRssBytes() / (1024.0 * 1024.0) << " MB, peak estimate "
+         << memoryBudget.getPeakReserved() / (1024.0 * 1024.0) << " MB";
+
+    if (memoryBudget.getLimit() > 0)
+    {
+        cout << " of " << memoryBudget.getLimit() / (1024.0 * 1024.0) << " MB budget, "
+             << memoryBudget.getDelayedCount() << " tasks delayed for " << memoryBudget.getTotalWaitMs() << " ms";
+    }
+
+    cout << endl << defaultfloat << setprecision(6);
 }
 
 /**
  * @brief Allocates a new flowshop object depending on the selected algorithm and
  * returns a pointer to the newly created object.
  * 
- * @param inputFile Input file that contains the job processing time matrix which will be passed to the flowshop object
- * @param alg Index of the flowshop algorithm to allocate. 0 = Standard, 1 = With Blocking, 2 = With No Wait.
+ * @param instance Instance containing the job processing time matrix which will be shared with the flowshop object
+ * @param alg Index of the flowshop algorithm to allocate. 0 = Standard, 1 = With Blocking, 2 = With No Wait, 3 = With Setup Times,
+ * 4 = With Limited Buffers.
+ * @param setups Setup times of the instance, only used by algorithm 3
+ * @param bufferSizes Buffer sizes of the instance, only used by algorithm 4
  * @return Returns a pointer to the newly created flowshop object
  */
-FlowshopBasic* Experiment::allocFlowShop(const char* inputFile, int alg)
+FlowshopBasic* Experiment::allocFlowShop(InstancePtr instance, int alg, SetupTimesPtr setups, const vector<int>& bufferSizes)
 {
     FlowshopBasic* objectiveFs = nullptr;
 
     switch (alg)
     {
         case 0:
-            objectiveFs = new FlowshopBasic(inputFile);
+            objectiveFs = new FlowshopBasic(instance);
             break;
         case 1:
-            objectiveFs = new FlowshopBlocking(inputFile);
+            objectiveFs = new FlowshopBlocking(instance);
             break;
         case 2:
-            objectiveFs = new FlowshopNoWait(inputFile);
+            objectiveFs = new FlowshopNoWait(instance);
+            break;
+        case 3:
+            objectiveFs = new FlowshopSDST(instance, setups);
+            break;
+        case 4:
+            objectiveFs = new FlowshopBuffered(instance, bufferSizes);
             break;
     }
 
     return objectiveFs;
 }
 
+/**
+ * @brief Reads the test parameters for every flowshop variant in the ini param file.
+ * Each section named [test.*] describes one variant. If there are no such sections,
+ * the [test] section alone is used.
+ * 
+ * @return Returns a vector with the test parameters of each variant
+ */
+vector<TestParams> Experiment::readAllTestParams()
+{
+    vector<TestParams> variants;
+
+    for (auto& section : iniParams.getSectionNames())
+    {
+        if (section.compare(0, strlen(INI_TEST_VARIANT), INI_TEST_VARIANT) == 0)
+            variants.push_back(readTestParams(section));
+    }
+
+    if (variants.empty())
+        variants.push_back(readTestParams(INI_TEST_SECTION));
+
+    return variants;
+}
+
 /**
  * @brief Reads the experiment test parameters in from the ini param file
- * and places them in a TestParams struct.
+ * and places them in a TestParams struct. Entries missing from the given
+ * section are inherited from the [test] section.
  * 
+ * @param section Name of the ini section to read
  * @return Returns the experiment test parameters in a TestParams struct
  */
-TestParams Experiment::readTestParams()
+TestParams Experiment::readTestParams(const std::string& section)
 {
     TestParams p = { };
 
-    p.minTestFile = iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_MINFILE, 0);
-    p.maxTestFile = iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_MAXFILE, 120);
-    p.numThreads = iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_NUMTHREADS, 1);
-    p.algorithm = iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_ALGORITHM, 0);
-    p.inputFilesDir = iniParams.getEntry(INI_TEST_SECTION, INI_TEST_INPUTFILEDIR, "");
-    p.resultsFile = iniParams.getEntry(INI_TEST_SECTION, INI_TEST_RESULTSFILE, "");
-    p.timesFile = iniParams.getEntry(INI_TEST_SECTION, INI_TEST_TIMESFILE, "");
+    p.name = section;
+    p.minTestFile = iniParams.getEntryAs<int>(section, INI_TEST_MINFILE, iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_MINFILE, 0));
+    p.maxTestFile = iniParams.getEntryAs<int>(section, INI_TEST_MAXFILE, iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_MAXFILE, 120));
+    p.numThreads = iniParams.getEntryAs<int>(section, INI_TEST_NUMTHREADS, iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_NUMTHREADS, 1));
+    p.algorithm = iniParams.getEntryAs<int>(section, INI_TEST_ALGORITHM, iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_ALGORITHM, 0));
+    p.inputFilesDir = iniParams.getEntry(section, INI_TEST_INPUTFILEDIR, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_INPUTFILEDIR, ""));
+    p.setupTimesDir = iniParams.getEntry(section, INI_TEST_SETUPTIMESDIR, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_SETUPTIMESDIR, ""));
+    p.dueDatesDir = iniParams.getEntry(section, INI_TEST_DUEDATESDIR, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_DUEDATESDIR, ""));
+    p.resultsFile = iniParams.getEntry(section, INI_TEST_RESULTSFILE, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_RESULTSFILE, ""));
+    p.timesFile = iniParams.getEntry(section, INI_TEST_TIMESFILE, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_TIMESFILE, ""));
+    p.timesFormat = parseTimesFormat(iniParams.getEntry(section, INI_TEST_TIMESFORMAT, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_TIMESFORMAT, "csv")));
+    p.timesCompress = iniParams.getEntryAs<int>(section, INI_TEST_TIMESCOMPRESS, iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_TIMESCOMPRESS, 0)) != 0;
+    p.ganttDir = iniParams.getEntry(section, INI_TEST_GANTTDIR, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_GANTTDIR, ""));
+    p.jsonlFile = iniParams.getEntry(section, INI_TEST_JSONLFILE, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_JSONLFILE, ""));
+    p.journalFile = iniParams.getEntry(section, INI_TEST_JOURNALFILE, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_JOURNALFILE, ""));
+    p.resume = iniParams.getEntryAs<int>(section, INI_TEST_RESUME, iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_RESUME, 0)) != 0;
+    p.perfCounters = iniParams.getEntryAs<int>(section, INI_TEST_PERFCOUNTERS, iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_PERFCOUNTERS, 0)) != 0;
+    p.fsyncPolicy = parseFsyncPolicy(iniParams.getEntry(section, INI_TEST_FSYNCPOLICY, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_FSYNCPOLICY, "none")));
+    p.seed = iniParams.getEntryAs<unsigned int>(section, INI_TEST_SEED, iniParams.getEntryAs<unsigned int>(INI_TEST_SECTION, INI_TEST_SEED, 0));
+    p.goldenFile = iniParams.getEntry(section, INI_TEST_GOLDENFILE, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_GOLDENFILE, ""));
+    p.baselineFile = iniParams.getEntry(section, INI_TEST_BASELINEFILE, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_BASELINEFILE, ""));
+    p.verify.qualityTolerance = iniParams.getEntryAs<double>(section, INI_TEST_QUALITYTOL, iniParams.getEntryAs<double>(INI_TEST_SECTION, INI_TEST_QUALITYTOL, 0.0));
+    p.verify.timeTolerance = iniParams.getEntryAs<double>(section, INI_TEST_TIMETOL, iniParams.getEntryAs<double>(INI_TEST_SECTION, INI_TEST_TIMETOL, 0.25));
+    p.verify.instanceTimeTolerance = iniParams.getEntryAs<double>(section, INI_TEST_INSTTIMETOL, iniParams.getEntryAs<double>(INI_TEST_SECTION, INI_TEST_INSTTIMETOL, 1.0));
+    p.verify.timeFloorMs = iniParams.getEntryAs<double>(section, INI_TEST_TIMEFLOOR, iniParams.getEntryAs<double>(INI_TEST_SECTION, INI_TEST_TIMEFLOOR, 10.0));
+    p.verify.timeRepetitions = iniParams.getEntryAs<int>(section, INI_TEST_TIMEREPS, iniParams.getEntryAs<int>(INI_TEST_SECTION, INI_TEST_TIMEREPS, 3));
+
+    // Seeded runs are reproducible, so they must match the golden results exactly
+    const string quality = iniParams.getEntry(section, INI_TEST_VERIFYQUALITY, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_VERIFYQUALITY, p.seed != 0 ? "exact" : "noworse"));
+    if (!parseQualityCheck(quality, p.verify.quality))
+    {
+        cout << "Warning: verifyQuality must be exact or noworse. Defaulting to noworse." << endl;
+        p.verify.quality = QUALITY_NO_WORSE;
+    }
+
+    // Due date objectives are chosen by name
+    const string objective = iniParams.getEntry(section, INI_TEST_OBJECTIVE, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_OBJECTIVE, "cmax"));
+    if (!parseObjectiveType(objective, p.objective))
+    {
+        cout << "Warning: objective must be cmax, tardiness, weightedTardiness or maxLateness. Defaulting to cmax." << endl;
+        p.objective = OBJ_CMAX;
+    }
+
+    // Check bounds for test file range
+    if (p.maxTestFile < p.minTestFile)
+    {
+        cout << "Warning: maxTestFile is less than minTestFile. Running minTestFile only." << endl;
+        p.maxTestFile = p.minTestFile;
+    }
 
     // Check bounds for numThreads
-    if (p.numThreads < 1 || p.numThreads > 16)
+    if (p.numThreads < 1 || p.numThreads > MAX_THREADS)
     {
         cout << "Warning: Number of threads invalid. Defaulting to default 1 threads." << endl;
         p.numThreads = 1;
     }
 
+    // Buffer sizes of the limited buffer variant, read from each data set file if not given
+    const string bufferSizes = iniParams.getEntry(section, INI_TEST_BUFFERSIZES, iniParams.getEntry(INI_TEST_SECTION, INI_TEST_BUFFERSIZES, ""));
+    if (!bufferSizes.empty() && !FlowshopBuffered::parseBufferSizes(bufferSizes, p.bufferSizes))
+    {
+        cout << "Warning: bufferSizes must be sizes or inf, separated by commas. Reading them from the data set files." << endl;
+        p.bufferSizes.clear();
+    }
+
     // Check bounds for algorithm selection
-    if (p.algorithm < 0 || p.algorithm > 2)
+    if (p.algorithm < 0 || p.algorithm > 4)
     {
         cout << "Warning: Algorithm selection invalid. Defaulting to algorithm 0." << endl;
         p.algorithm = 0;
     }
 
+    // Check that compressed times files can be written
+    if (p.timesCompress && !TimesFile::compressionAvailable())
+    {
+        cout << "Warning: zlib support is not available. Times files will not be compressed." << endl;
+        p.timesCompress = false;
+    }
+
+    // Resuming needs a journal to resume from
+    if (p.resume && p.journalFile.empty())
+    {
+        cout << "Warning: resume is set without a journalFile. All tasks will be run." << endl;
+        p.resume = false;
+    }
+
     return p;
 }
 
@@ -316,26 +1722,31 @@ int Experiment::runDebugSeq(int* seq, size_t seqSize)
     // Retrieve test parameters from ini file
     TestParams p = readTestParams();
 
-    if (p.algorithm == 1)
-        cout << "Running Flow Shop with Blocking ..." << endl;
-    else if (p.algorithm == 2)
-        cout << "Running Flow Shop with No Wait ..." << endl;
-    else
-        cout << "Running Flow Shop Scheduling ..." << endl;
+    cout << "Running " << algorithmName(p.algorithm) << " ..." << endl;
 
     cout << endl;
 
     // Prepare pointer to results
     fsSol result = nullptr;
 
+    // Map the instance pack, if the input is one
+    shared_ptr<InstancePack> pack = nullptr;
+    if (InstancePack::isPackFile(p.inputFilesDir))
+        pack = InstancePack::open(p.inputFilesDir.c_str());
+
     for (int i = p.minTestFile; i <= p.maxTestFile; i++)
     {
-        string fullInputPath = p.inputFilesDir + std::to_string(i) + ".txt";
+        string fullInputPath = inputName(p.inputFilesDir, i);
 
         cout << "Input file: " << fullInputPath << endl;
 
         // Get the flowshop objective function that we want to optimize
-        auto objectiveFs = allocFlowShop(fullInputPath.c_str(), p.algorithm);
+        InstancePtr instance = pack != nullptr ? pack->getInstance(i) : InstanceCache::global().get(fullInputPath);
+        SetupTimesPtr setups = p.algorithm == 3 ? loadSetupTimes(p, i) : nullptr;
+        vector<int> bufferSizes = p.algorithm == 4 ? loadBufferSizes(p, i) : vector<int>();
+        auto objectiveFs = allocFlowShop(instance, p.algorithm, setups, bufferSizes);
+        if (objectiveFs != nullptr && usesDueDates(p))
+            objectiveFs->setDueDates(loadDueDates(p, i));
         if (objectiveFs == nullptr)
         {
             cout << "Objective flowshop function encountered an error." << endl;
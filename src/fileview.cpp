@@ -0,0 +1,215 @@
+/**
+ * @file fileview.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the FileView class.
+ * @version 0.1
+ * @date 2019-05-28
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "fileview.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define FILEVIEW_USE_MMAP
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+using namespace util;
+
+/**
+ * @brief Construct a new FileView object
+ */
+FileView::FileView()
+    : viewData(nullptr), viewSize(0), mapped(false)
+{
+}
+
+/**
+ * @brief Destroys the FileView object and releases the file contents
+ */
+FileView::~FileView()
+{
+    close();
+}
+
+/**
+ * @brief Opens the given file and makes its contents available through data()
+ * 
+ * @param filePath Path to the file, or "-" to read from stdin
+ * @return Returns true if the file was opened and read. Otherwise false.
+ */
+bool FileView::open(const char* filePath)
+{
+    close();
+
+#ifdef FILEVIEW_USE_MMAP
+    if (std::strcmp(filePath, "-") == 0)
+        return readStream(STDIN_FILENO);
+
+    int fd = ::open(filePath, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    // Pipes and devices cannot be mapped, read them instead
+    if (!S_ISREG(st.st_mode))
+    {
+        bool success = readStream(fd);
+        ::close(fd);
+        return success;
+    }
+
+    // Empty files are valid, but cannot be mapped
+    if (st.st_size == 0)
+    {
+        ::close(fd);
+        return true;
+    }
+
+    void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (addr == MAP_FAILED)
+        return readFile(filePath);
+
+    madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    viewData = static_cast<const char*>(addr);
+    viewSize = static_cast<size_t>(st.st_size);
+    mapped = true;
+    return true;
+#else
+    if (std::strcmp(filePath, "-") == 0)
+    {
+        buffer.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+        viewData = buffer.data();
+        viewSize = buffer.size();
+        return true;
+    }
+
+    return readFile(filePath);
+#endif
+}
+
+/**
+ * @brief Releases the file contents. Called automatically on destruction.
+ */
+void FileView::close()
+{
+#ifdef FILEVIEW_USE_MMAP
+    if (mapped)
+        munmap(const_cast<char*>(viewData), viewSize);
+#endif
+
+    viewData = nullptr;
+    viewSize = 0;
+    mapped = false;
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+/**
+ * @brief Returns a pointer to the file contents. The data is not null terminated.
+ * 
+ * @return Returns a pointer to the file contents, or nullptr if the file is empty
+ */
+const char* FileView::data() const
+{
+    return viewData;
+}
+
+/**
+ * @brief Returns the size of the file contents in bytes
+ * 
+ * @return Returns the size of the file contents in bytes
+ */
+size_t FileView::size() const
+{
+    return viewSize;
+}
+
+/**
+ * @brief Returns true if the file contents are memory-mapped rather than buffered
+ * 
+ * @return Returns true if the file contents are memory-mapped
+ */
+bool FileView::isMapped() const
+{
+    return mapped;
+}
+
+/**
+ * @brief Reads a stream from the given file descriptor into the internal buffer
+ * until end of file. Used for pipes, devices and stdin.
+ * 
+ * @param fd File descriptor to read from
+ * @return Returns true on success. Otherwise false.
+ */
+bool FileView::readStream(int fd)
+{
+#ifdef FILEVIEW_USE_MMAP
+    const size_t chunkSize = 64 * 1024;
+    size_t used = 0;
+
+    for (;;)
+    {
+        buffer.resize(used + chunkSize);
+        ssize_t n = ::read(fd, buffer.data() + used, chunkSize);
+        if (n < 0)
+        {
+            buffer.clear();
+            return false;
+        }
+        else if (n == 0)
+        {
+            break;
+        }
+
+        used += static_cast<size_t>(n);
+    }
+
+    buffer.resize(used);
+    viewData = buffer.data();
+    viewSize = buffer.size();
+    return true;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+/**
+ * @brief Reads a complete file into the internal buffer. Used where
+ * memory mapping is unavailable or fails.
+ * 
+ * @param filePath Path to the file
+ * @return Returns true on success. Otherwise false.
+ */
+bool FileView::readFile(const char* filePath)
+{
+    std::ifstream is(filePath, std::ios::in | std::ios::binary);
+    if (!is.good()) return false;
+
+    buffer.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    viewData = buffer.data();
+    viewSize = buffer.size();
+    return true;
+}
+
+// =========================
+// End of fileview.cpp
+// =========================
@@ -11,8 +11,11 @@
 
 #include <stdexcept>
 #include <fstream>
+#include <limits>
 #include "flowshopbasic.h"
+#include "instancecache.h"
 #include "mem.h"
+#include "timesfile.h"
 
 using namespace fshop;
 
@@ -29,44 +32,90 @@ inline int max(int val1, int val2)
     else return val2;
 }
 
+/**
+ * @brief Parses the name of an objective, as used in parameter files
+ * 
+ * @param name One of "cmax", "tardiness", "weightedTardiness" or "maxLateness"
+ * @param out Out reference that receives the objective
+ * @return Returns true if the name is known. Otherwise false.
+ */
+bool fshop::parseObjectiveType(const std::string& name, ObjectiveType& out)
+{
+    if (name == "cmax")
+        out = OBJ_CMAX;
+    else if (name == "tardiness")
+        out = OBJ_TOTAL_TARDINESS;
+    else if (name == "weightedTardiness")
+        out = OBJ_WEIGHTED_TARDINESS;
+    else if (name == "maxLateness")
+        out = OBJ_MAX_LATENESS;
+    else
+        return false;
+
+    return true;
+}
+
+/**
+ * @brief Returns the parameter file name of an objective
+ */
+const char* fshop::objectiveTypeName(ObjectiveType type)
+{
+    switch (type)
+    {
+        case OBJ_TOTAL_TARDINESS: return "tardiness";
+        case OBJ_WEIGHTED_TARDINESS: return "weightedTardiness";
+        case OBJ_MAX_LATENESS: return "maxLateness";
+        default: return "cmax";
+    }
+}
+
 // ============================================================
 
 /**
- * @brief Constructs a new SlowshopSolution object
+ * @brief Start and departure time matrices of a solution, stored contiguously
+ * with row pointers into each block. Never copied once built.
+ */
+struct FlowshopSolution::TimeMatrices
+{
+    std::vector<int> startTimes;
+    std::vector<int> departTimes;
+    std::vector<int*> startRows;
+    std::vector<int*> departRows;
+
+    TimeMatrices(size_t rows, size_t cols)
+        : startTimes(rows * cols), departTimes(rows * cols), startRows(rows), departRows(rows)
+    {
+        for (size_t r = 0; r < rows; r++)
+        {
+            startRows[r] = &startTimes[r * cols];
+            departRows[r] = &departTimes[r * cols];
+        }
+    }
+
+    TimeMatrices(const TimeMatrices& o) = delete;
+    TimeMatrices& operator=(const TimeMatrices& o) = delete;
+};
+
+/**
+ * @brief Constructs a new FlowshopSolution object
  * 
- * @param _startimeMatrix Pointer to the start times matrix. This class takes ownership of the pointer and will destroy it.
- * @param _departTimeMatrix Pointer to the departure times matrix. This class takes ownership of the pointer and will destroy it.
- * @param _tMatrixRows Number of rows (machines) in the start and departure time matrices
- * @param _jobSeq Pointer to the job sequence array. This class takes ownership of the pointer and will destroy it.
+ * @param _evaluator Flowshop used to calculate the time matrices when they are first accessed
+ * @param _jobSeq Pointer to the job sequence array. The sequence is copied.
  * @param _seqSize Size of the job sequence array
- * @param _cmax Cmax value of the flowshop result
- * @param _totalFlowTime Total flow time of the flowshop result
+ * @param _value Objective values of the flowshop result
  */
-FlowshopSolution::FlowshopSolution(int** _startimeMatrix, int** _departTimeMatrix, size_t _tMatrixRows, int* _jobSeq, size_t _seqSize, int _cmax, int _totalFlowTime)
-    : startTimeMatrix(_startimeMatrix), departTimeMatrix(_departTimeMatrix), numMachines(_tMatrixRows), seqSize(_seqSize), cmax(_cmax), totalFlowTime(_totalFlowTime)
+FlowshopSolution::FlowshopSolution(std::shared_ptr<const FlowshopBasic> _evaluator, const int* _jobSeq, size_t _seqSize, const ObjectiveValue& _value)
+    : seqSize(_seqSize), numMachines(_evaluator != nullptr ? _evaluator->getInstance()->getTotalMachines() : 0),
+      cmax(_value.cmax), totalFlowTime(_value.totalFlowTime), value(_value), evaluator(_evaluator), timeMatrices(nullptr)
 {
     if (_jobSeq == nullptr)
         throw std::invalid_argument("Error: _jobSeq cannot be nullptr");
-    else if (_startimeMatrix == nullptr)
-        throw std::invalid_argument("Error: _startimeMatrix cannot be nullptr");
-    else if (_departTimeMatrix == nullptr)
-        throw std::invalid_argument("Error: _departTimeMatrix cannot be nullptr");
+    else if (evaluator == nullptr)
+        throw std::invalid_argument("Error: _evaluator cannot be nullptr");
     else if (seqSize == 0)
         throw std::invalid_argument("Error: _seqSize cannot be zero");
 
-    jobSequence = util::allocArray<int>(seqSize);
-    for (size_t i = 0; i < seqSize; i++)
-        jobSequence[i] = _jobSeq[i];
-}
-
-/**
- * @brief Destroys the FlowshopSolution object
- */
-FlowshopSolution::~FlowshopSolution()
-{
-    util::releaseArray<int>(jobSequence);
-    util::releaseMatrix<int>(startTimeMatrix, numMachines);
-    util::releaseMatrix<int>(departTimeMatrix, numMachines);
+    jobSequence.assign(_jobSeq, _jobSeq + seqSize);
 }
 
 /**
@@ -76,7 +125,7 @@ FlowshopSolution::~FlowshopSolution()
  */
 const int* const FlowshopSolution::getJobSeq()
 {
-    return const_cast<const int* const>(jobSequence);
+    return jobSequence.data();
 }
 
 /**
@@ -99,23 +148,48 @@ std::string FlowshopSolution::getJobSeqAsString()
 }
 
 /**
- * @brief Returns a const pointer to the start times matrix.
+ * @brief Returns a const pointer to the start times matrix, calculating
+ * the time matrices if this is the first access.
  * 
  * @return Returns a const pointer to the start times matrix.
  */
 const int** const FlowshopSolution::getStartTimeMatrix()
 {
-    return const_cast<const int** const>(startTimeMatrix);
+    return const_cast<const int**>(getTimeMatrices().startRows.data());
 }
 
 /**
- * @brief Returns a const pointer to the departure times matrix.
+ * @brief Returns a const pointer to the departure times matrix, calculating
+ * the time matrices if this is the first access.
  * 
  * @return Returns a const pointer to the departure times matrix.
  */
 const int** const FlowshopSolution::getDepartTimeMatrix()
 {
-    return const_cast<const int** const>(departTimeMatrix);
+    return const_cast<const int**>(getTimeMatrices().departRows.data());
+}
+
+/**
+ * @brief Returns true if the time matrices have already been calculated
+ */
+bool FlowshopSolution::hasTimeMatrices() const
+{
+    return timeMatrices != nullptr;
+}
+
+/**
+ * @brief Returns the time matrices, calculating them on first access
+ */
+const FlowshopSolution::TimeMatrices& FlowshopSolution::getTimeMatrices()
+{
+    if (timeMatrices == nullptr)
+    {
+        auto matrices = std::make_shared<TimeMatrices>(numMachines, seqSize);
+        evaluator->calcTimeMatrices(jobSequence.data(), seqSize, matrices->startRows.data(), matrices->departRows.data());
+        timeMatrices = matrices;
+    }
+
+    return *timeMatrices;
 }
 
 /**
@@ -123,46 +197,83 @@ const int** const FlowshopSolution::getDepartTimeMatrix()
  * that starts with the given fileNamePrefix.
  * 
  * @param fileNamePrefix Start of the path/file which will contain the data
+ * @param policy When the written data is forced to disk
  * @return Returns true on success. Otherwise false.
  */
-bool FlowshopSolution::outputTimesCsv(const std::string& fileNamePrefix)
+bool FlowshopSolution::outputTimesCsv(const std::string& fileNamePrefix, util::FsyncPolicy policy)
 {
     using namespace std;
 
+    const int** const startTimeMatrix = getStartTimeMatrix();
+    const int** const departTimeMatrix = getDepartTimeMatrix();
+
     // Create file name strings
     string startTimesFile = fileNamePrefix + "starttimes.csv";
     string departTimesFile = fileNamePrefix + "departtimes.csv";
 
     // Open files
-    ofstream startOs = ofstream(startTimesFile, ios::trunc | ios::out);
-    if (!startOs.good()) return false;
+    util::CsvWriter startCsv;
+    if (!startCsv.open(startTimesFile.c_str(), policy)) return false;
 
-    ofstream departOs = ofstream(departTimesFile, ios::trunc | ios::out);
-    if (!departOs.good()) return false;
+    util::CsvWriter departCsv;
+    if (!departCsv.open(departTimesFile.c_str(), policy)) return false;
 
     // Output start times and departure times data to the files
     for (size_t m = 0; m < numMachines; m++)
     {
         for (size_t j = 0; j < seqSize; j++)
         {
-            startOs << startTimeMatrix[m][j];
-            departOs << departTimeMatrix[m][j];
-
-            if (j < seqSize - 1)
-            {
-                startOs << ",";
-                departOs << ",";
-            }
+            startCsv.field(startTimeMatrix[m][j]);
+            departCsv.field(departTimeMatrix[m][j]);
         }
 
-        startOs << endl;
-        departOs << endl;
+        startCsv.endRow();
+        departCsv.endRow();
     }
 
     // Close file handles and return
-    startOs.close();
-    departOs.close();
-    return true;
+    bool startOk = startCsv.close();
+    bool departOk = departCsv.close();
+    return startOk && departOk;
+}
+
+/**
+ * @brief Outputs the job sequence, start time matrix and departure time matrix
+ * to a single compact binary file. See timesfile.h for the format.
+ * 
+ * @param filePath Path of the output file
+ * @param compress If true, the data is also compressed when zlib is available
+ * @param policy When written data is forced to disk
+ * @return Returns true on success. Otherwise false.
+ */
+bool FlowshopSolution::outputTimesBin(const std::string& filePath, bool compress, util::FsyncPolicy policy)
+{
+    const TimeMatrices& times = getTimeMatrices();
+    return TimesFile::write(filePath.c_str(), jobSequence.data(), times.startRows.data(), times.departRows.data(), numMachines, seqSize, compress, policy);
+}
+
+/**
+ * @brief Outputs one Gantt chart row per machine and job, in the format read
+ * by results/gen-gantt.r. Rows are streamed straight from the time matrices.
+ * 
+ * @param filePath Path of the output *.csv file
+ * @param policy When written data is forced to disk
+ * @return Returns true on success. Otherwise false.
+ */
+bool FlowshopSolution::outputGanttCsv(const std::string& filePath, util::FsyncPolicy policy)
+{
+    const TimeMatrices& times = getTimeMatrices();
+
+    util::CsvWriter csv;
+    if (!csv.open(filePath.c_str(), policy)) return false;
+
+    TimesFile::writeGanttHeader(csv);
+
+    size_t item = 1;
+    for (size_t m = 0; m < numMachines; m++)
+        item = TimesFile::writeGanttRows(csv, item, m, times.startRows[m], times.departRows[m], seqSize);
+
+    return csv.close();
 }
 
 /**
@@ -184,74 +295,55 @@ void FlowshopSolution::outputAll(std::ostream& os)
     std::cout << std::endl;
 
     std::cout << "Cmax: " << cmax << std::endl;
-    std::cout << "TFT: " << totalFlowTime << std::endl << std::endl;
+    std::cout << "TFT: " << totalFlowTime << std::endl;
+
+    if (evaluator->getDueDates() != nullptr)
+    {
+        std::cout << "Total tardiness: " << value.totalTardiness << std::endl;
+        std::cout << "Weighted tardiness: " << value.weightedTardiness << std::endl;
+        std::cout << "Max lateness: " << value.maxLateness << std::endl;
+    }
+
+    std::cout << std::endl;
 
     std::cout << "Starting times matrix:" << std::endl;
-    util::outputMatrix(std::cout, startTimeMatrix, numMachines, seqSize, 4);
+    util::outputMatrix(std::cout, getStartTimeMatrix(), numMachines, seqSize, 4);
     std::cout << std::endl;
 
     std::cout << "Departure times matrix:" << std::endl;
-    util::outputMatrix(std::cout, departTimeMatrix, numMachines, seqSize, 4);
+    util::outputMatrix(std::cout, getDepartTimeMatrix(), numMachines, seqSize, 4);
     std::cout << std::endl;
 }
 
-/**
- * @brief Copy constructor for the FlowshopSolution class
- */
-FlowshopSolution::FlowshopSolution(const FlowshopSolution& obj)
-    : startTimeMatrix(obj.startTimeMatrix), departTimeMatrix(obj.departTimeMatrix), numMachines(obj.numMachines), seqSize(obj.seqSize), cmax(obj.cmax), totalFlowTime(obj.totalFlowTime)
-{
-    if (obj.jobSequence == nullptr)
-        throw std::invalid_argument("Error: jobSequence cannot be nullptr");
-    else if (seqSize == 0)
-        throw std::invalid_argument("Error: seqSize cannot be zero");
-
-    jobSequence = util::allocArray<int>(seqSize);
-    for (size_t i = 0; i < seqSize; i++)
-        jobSequence[i] = obj.jobSequence[i];
-}
-
-/**
- * @brief Move constructor for the FlowshopSolution class
- */
-FlowshopSolution::FlowshopSolution(FlowshopSolution&& obj)
-    : numMachines(obj.numMachines), seqSize(obj.seqSize), cmax(obj.cmax), totalFlowTime(obj.totalFlowTime)
-{
-    jobSequence = obj.jobSequence;
-    startTimeMatrix = obj.startTimeMatrix;
-    departTimeMatrix = obj.departTimeMatrix;
-    obj.jobSequence = nullptr;
-    obj.startTimeMatrix = nullptr;
-    obj.departTimeMatrix = nullptr;
-}
-
 // ============================================================
 
 /**
- * @brief Constructs a new FlowshopBasic object
+ * @brief Constructs a new FlowshopBasic object. The instance is loaded through
+ * the process-wide instance cache.
  * 
  * @param procTimeMatrixFile File path to the file containing the job processing times matrix
  */
 FlowshopBasic::FlowshopBasic(const char* procTimeMatrixFile)
-    : startTimeMatrix(nullptr), ptMatrixRows(0), ptMatrixCols(0), funcCallCounter(0)
+    : FlowshopBasic(InstanceCache::global().get(procTimeMatrixFile))
 {
-    // Attempt to load job processing times from the given file
-    procTimeMatrix = util::loadMatrixFromFile<int>(procTimeMatrixFile, ptMatrixRows, ptMatrixCols);
-    if (procTimeMatrix == nullptr)
-    {
-        std::string msg = "Error when loading matrix file: ";
-        msg += procTimeMatrixFile;
-        throw std::runtime_error(msg);
-    }
 }
 
 /**
- * @brief Destroys the FlowshopBasic object
+ * @brief Constructs a new FlowshopBasic object from an already loaded instance
  * 
+ * @param _instance Shared pointer to the instance containing the job processing times matrix
  */
-FlowshopBasic::~FlowshopBasic()
+FlowshopBasic::FlowshopBasic(InstancePtr _instance)
+    : instance(_instance), procTimeMatrix(nullptr), jobTimeMatrix(nullptr), ptMatrixRows(0), ptMatrixCols(0), funcCallCounter(0), sharedEvaluator(nullptr),
+      dueDates(nullptr), jobDueDates(nullptr), jobWeights(nullptr)
 {
-    util::releaseMatrix<int>(procTimeMatrix, ptMatrixRows);
+    if (instance == nullptr)
+        throw std::invalid_argument("Error: _instance cannot be nullptr");
+
+    procTimeMatrix = instance->getProcTimeMatrix();
+    jobTimeMatrix = instance->getJobTimeMatrix();
+    ptMatrixRows = instance->getTotalMachines();
+    ptMatrixCols = instance->getTotalJobs();
 }
 
 /**
@@ -307,37 +399,136 @@ size_t FlowshopBasic::getFuncCallCounts()
     return funcCallCounter;
 }
 
+/**
+ * @brief Returns the shared instance holding the processing time matrix
+ * 
+ * @return Returns a shared pointer to the instance
+ */
+InstancePtr FlowshopBasic::getInstance() const
+{
+    return instance;
+}
+
+/**
+ * @brief Sets the due dates and weights of the jobs, which enables the due date
+ * objectives. Throws std::invalid_argument if they do not have one entry per job.
+ * 
+ * @param _dueDates Shared pointer to the due dates, or nullptr to remove them
+ */
+void FlowshopBasic::setDueDates(DueDatesPtr _dueDates)
+{
+    if (_dueDates != nullptr && _dueDates->getTotalJobs() != ptMatrixCols)
+    {
+        std::string msg = "Error: Due dates do not match the number of jobs: ";
+        msg += _dueDates->getFilePath();
+        throw std::invalid_argument(msg);
+    }
+
+    dueDates = _dueDates;
+    jobDueDates = dueDates != nullptr ? dueDates->getDueDates() : nullptr;
+    jobWeights = dueDates != nullptr ? dueDates->getWeights() : nullptr;
+    sharedEvaluator = nullptr;
+}
+
+/**
+ * @brief Returns the due dates of the jobs
+ * 
+ * @return Returns a shared pointer to the due dates, or nullptr if there are none
+ */
+DueDatesPtr FlowshopBasic::getDueDates() const
+{
+    return dueDates;
+}
+
 /**
  * @brief Calculates the objective flowshop scheduling problem result using the given
- * job sequence.
+ * job sequence. The start and departure time matrices of the returned solution are
+ * only calculated if they are accessed.
  * 
  * @param seq Pointer to an int array containing the job sequence permutation
  * @param seqSize Size of the job sequence array
  * @return Returns a unique_ptr to a FlowshopSolution object that contains all solution results
  */
 std::unique_ptr<FlowshopSolution> FlowshopBasic::calcObjective(int* seq, size_t seqSize)
+{
+    return makeSolution(seq, seqSize, evaluate(seq, seqSize));
+}
+
+/**
+ * @brief Calculates only the objective values of the given job sequence.
+ * No time matrices are built, and no memory is allocated after the first call.
+ * 
+ * @param seq Pointer to an int array containing the job sequence permutation
+ * @param seqSize Size of the job sequence array
+ * @return Returns the objective values of the job sequence
+ */
+ObjectiveValue FlowshopBasic::evaluate(const int* seq, size_t seqSize)
 {
     // Validate input parameters
     validateParams(seq, seqSize);
 
-    // Allocate completion (departure) time matrix and start time matrix
-    auto compTimeMatrix = allocTimeMatrix(ptMatrixRows, seqSize);
-    startTimeMatrix = allocTimeMatrix(ptMatrixRows, seqSize);
+    if (scratch.size() < getScratchSize())
+        scratch.resize(getScratchSize());
 
-    // Initialize completion time matrix and start time matrix
-    initTimeMatrix(compTimeMatrix, seq, ptMatrixRows, seqSize);
-    calcStartTimeCol(startTimeMatrix, compTimeMatrix, seq, 0, ptMatrixRows, seqSize);
+    // Increment obj func call counter and return result
+    funcCallCounter += 1;
+    return calcTimes(seq, seqSize, scratch.data(), nullptr, nullptr);
+}
 
-    // Calculate all completion and start times
-    calcTimeMatrix(compTimeMatrix, seq, ptMatrixRows, seqSize);
+/**
+ * @brief Creates a solution for a job sequence whose objective values are already known,
+ * without evaluating the sequence again
+ * 
+ * @param seq Pointer to an int array containing the job sequence permutation
+ * @param seqSize Size of the job sequence array
+ * @param value Objective values of the job sequence, as returned by evaluate()
+ * @return Returns a unique_ptr to a FlowshopSolution object for the job sequence
+ */
+std::unique_ptr<FlowshopSolution> FlowshopBasic::makeSolution(const int* seq, size_t seqSize, const ObjectiveValue& value)
+{
+    // Solutions may outlive this object, so they share an immutable copy of it
+    if (sharedEvaluator == nullptr)
+    {
+        FlowshopBasic* copy = clone();
+        copy->setDueDates(dueDates);
+        sharedEvaluator = std::shared_ptr<const FlowshopBasic>(copy);
+    }
 
-    // Construct solution struct
-    auto retVal = std::unique_ptr<FlowshopSolution>(new FlowshopSolution(startTimeMatrix, compTimeMatrix, ptMatrixRows, seq, seqSize, 
-        getCmax(compTimeMatrix, ptMatrixRows, seqSize), getTFT(compTimeMatrix, ptMatrixRows, seqSize)));
+    return std::unique_ptr<FlowshopSolution>(new FlowshopSolution(sharedEvaluator, seq, seqSize, value));
+}
 
-    // Increment obj func call counter and return result
-    funcCallCounter += 1;
-    return std::move(retVal);
+/**
+ * @brief Fills the start and departure time matrices of a job sequence.
+ * Does not count as an objective function call.
+ * 
+ * @param seq Pointer to an int array containing the job sequence permutation
+ * @param seqSize Size of the job sequence array
+ * @param startTimeMatrix Start times matrix with getTotalMachines() rows of seqSize columns
+ * @param departTimeMatrix Departure times matrix with getTotalMachines() rows of seqSize columns
+ */
+void FlowshopBasic::calcTimeMatrices(const int* seq, size_t seqSize, int** startTimeMatrix, int** departTimeMatrix) const
+{
+    if (startTimeMatrix == nullptr || departTimeMatrix == nullptr)
+        throw std::invalid_argument("Error: time matrices cannot be nullptr");
+
+    std::vector<int> colBuffer(getScratchSize());
+    calcTimes(seq, seqSize, colBuffer.data(), startTimeMatrix, departTimeMatrix);
+}
+
+/**
+ * @brief Returns a new flowshop of the same problem variant, sharing the same instance
+ */
+FlowshopBasic* FlowshopBasic::clone() const
+{
+    return new FlowshopBasic(instance);
+}
+
+/**
+ * @brief Returns the number of ints of column buffer needed by calcTimes()
+ */
+size_t FlowshopBasic::getScratchSize() const
+{
+    return 2 * ptMatrixRows;
 }
 
 /**
@@ -346,7 +537,7 @@ std::unique_ptr<FlowshopSolution> FlowshopBasic::calcObjective(int* seq, size_t
  * @param seq Job permutation sequence array
  * @param seqSize Size of job sequence array
  */
-void FlowshopBasic::validateParams(int* seq, size_t seqSize)
+void FlowshopBasic::validateParams(const int* seq, size_t seqSize)
 {
     // Make sure job sequence is not empty, or too large
     if (seqSize == 0 || seqSize > ptMatrixCols)
@@ -369,126 +560,95 @@ void FlowshopBasic::validateParams(int* seq, size_t seqSize)
 }
 
 /**
- * @brief Allocates the start times and completion time matrices
- * 
- * @param rows Number of rows (machines)
- * @param cols Number of columns (jobs)
- * @return Returns a pointer to the newly created matrix
+ * @brief Returns the objective values of an empty sequence
  */
-int** FlowshopBasic::allocTimeMatrix(size_t rows, size_t cols)
+ObjectiveValue FlowshopBasic::initialValue() const
 {
-    int** timeMatrix = util::allocMatrix<int>(rows, cols);
-    if (timeMatrix == nullptr)
-    {
-        std::cerr << "Error allocating time matrix." << std::endl;
-        throw std::bad_alloc();
-    }
+    ObjectiveValue value = { 0, 0, 0, 0, 0 };
+    if (jobDueDates != nullptr)
+        value.maxLateness = std::numeric_limits<int>::min();
 
-    util::initMatrix<int>(timeMatrix, rows, cols, 0);
-
-    return timeMatrix;
+    return value;
 }
 
 /**
- * @brief Initializes the completion time matrix (first row and first column)
- * so that it is ready to be completed with the main algorithm.
+ * @brief Calculates the departure times one column (job) at a time, keeping only the
+ * previous column, and returns the objective values. If time matrices are
+ * given, every column of start and departure times is also stored in them.
  * 
- * @param compTimeMatrix Pointer to completion time matrix
  * @param seq Pointer to job sequence
- * @param rows Number of rows (machines) in the completion time matrix
- * @param cols Number of columns (jobs) in the completion time matrix
+ * @param seqSize Size of the job sequence
+ * @param colBuffer Buffer of getScratchSize() ints for the current and previous columns
+ * @param startTimeMatrix Start times matrix to fill, or nullptr
+ * @param departTimeMatrix Departure times matrix to fill, or nullptr
+ * @return Returns the objective values of the job sequence
  */
-void FlowshopBasic::initTimeMatrix(int** compTimeMatrix, int* seq, size_t rows, size_t cols)
+ObjectiveValue FlowshopBasic::calcTimes(const int* seq, size_t seqSize, int* colBuffer, int** startTimeMatrix, int** departTimeMatrix) const
 {
-    // Set first job, first machine
-    compTimeMatrix[0][0] = procTimeMatrix[0][seq[0] - 1];
+    const size_t rows = ptMatrixRows;
+    int* prevDepart = colBuffer;
+    int* curDepart = colBuffer + rows;
 
-    // Set first job for all machines
-    for (size_t r = 1; r < rows; r++)
-    {
-        compTimeMatrix[r][0] = procTimeMatrix[r][seq[0] - 1] + compTimeMatrix[r - 1][0];
-    }
+    ObjectiveValue value = initialValue();
 
-    // Set first machine for all jobs
-    for (size_t c = 1; c < cols; c++)
+    for (size_t c = 0; c < seqSize; c++)
     {
-        compTimeMatrix[0][c] = compTimeMatrix[0][c - 1] + procTimeMatrix[0][seq[c] - 1];
-    }
-}
+        calcDepartCol(prevDepart, curDepart, seq, c);
+        addCompletion(value, seq[c], curDepart[rows - 1]);
 
-/**
- * @brief Calculates all remaining start and completion times for the current flowshop problem.
- * 
- * @param compTimeMatrix Pointer to completion time matrix
- * @param seq Pointer to job sequence
- * @param rows Number of rows (machines) in the completion time matrix
- * @param cols Number of columns (jobs) in the completion time matrix
- */
-void FlowshopBasic::calcTimeMatrix(int** compTimeMatrix, int* seq, size_t rows, size_t cols)
-{
-    for (size_t c = 1; c < cols; c++)
-    {
-        for (size_t r = 1; r < rows; r++)
+        if (departTimeMatrix != nullptr)
         {
-            int c1 = compTimeMatrix[r - 1][c];
-            int c2 = compTimeMatrix[r][c - 1];
+            const int* jobTimes = jobTimeMatrix[seq[c] - 1];
 
-            compTimeMatrix[r][c] = max(c1, c2) + procTimeMatrix[r][seq[c] - 1];
+            for (size_t r = 0; r < rows; r++)
+            {
+                departTimeMatrix[r][c] = curDepart[r];
+                startTimeMatrix[r][c] = curDepart[r] - jobTimes[r];
+            }
         }
 
-        FlowshopBasic::calcStartTimeCol(startTimeMatrix, compTimeMatrix, seq, c, rows, cols);
+        int* tmp = prevDepart;
+        prevDepart = curDepart;
+        curDepart = tmp;
     }
+
+    value.cmax = prevDepart[rows - 1];
+    return value;
 }
 
 /**
- * @brief Calculates the start times for a single column. Depends on values in completion time matrix.
+ * @brief Calculates the departure times of a single job on every machine.
  * 
- * @param startTimeMatrix Pointer to start times matrix
- * @param departTimeMatrix Pointer to departure (completion) times matrix
+ * @param prevDepart Departure times of the previous job in the sequence. Unused for the first job.
+ * @param curDepart Out array that receives the departure times of the current job
  * @param seq Pointer to job sequence
- * @param curCol Index of the column to be calculated
- * @param rows Number of rows (machines) in the completion time matrix
- * @param cols Number of columns (jobs) in the completion time matrix
+ * @param col Position of the current job in the sequence
  */
-void FlowshopBasic::calcStartTimeCol(int** startTimeMatrix, int** departTimeMatrix, int* seq, size_t curCol, size_t rows, size_t cols)
+void FlowshopBasic::calcDepartCol(const int* prevDepart, int* curDepart, const int* seq, size_t col) const
 {
-    for (size_t r = rows; r > 0; r--)
+    const size_t rows = ptMatrixRows;
+    const int* jobTimes = jobTimeMatrix[seq[col] - 1];
+
+    // The first job starts on each machine as soon as it leaves the previous one
+    if (col == 0)
     {
-        startTimeMatrix[r - 1][curCol] = departTimeMatrix[r - 1][curCol] - procTimeMatrix[r - 1][seq[curCol] - 1];
-    }
-}
+        curDepart[0] = jobTimes[0];
 
-/**
- * @brief Returns the cmax value for a given completion time matrix
- * 
- * @param compTimeMatrix Pointer to the completion time matrix
- * @param rows Number of rows (machines) in the completion time matrix
- * @param cols Number of columns (jobs) in the completion time matrix
- * @return Returns the cmax value (last row, last column) in the completion time matrix
- */
-int FlowshopBasic::getCmax(int** compTimeMatrix, size_t rows, size_t cols)
-{
-    return compTimeMatrix[rows - 1][cols - 1];
-}
+        for (size_t r = 1; r < rows; r++)
+            curDepart[r] = curDepart[r - 1] + jobTimes[r];
 
-/**
- * @brief Returns the total flow time value for a given completion time matrix
- * 
- * @param compTimeMatrix Pointer to the completion time matrix
- * @param rows Number of rows (machines) in the completion time matrix
- * @param cols Number of columns (jobs) in the completion time matrix
- * @return Returns the TFT value (sum of last row) in the completion time matrix
- */
-int FlowshopBasic::getTFT(int** compTimeMatrix, size_t rows, size_t cols)
-{
-    int sum = 0;
+        return;
+    }
+
+    curDepart[0] = prevDepart[0] + jobTimes[0];
 
-    for (size_t c = 0; c < cols; c++)
+    for (size_t r = 1; r < rows; r++)
     {
-        sum += compTimeMatrix[rows - 1][c];
-    }
+        int c1 = curDepart[r - 1];
+        int c2 = prevDepart[r];
 
-    return sum;
+        curDepart[r] = max(c1, c2) + jobTimes[r];
+    }
 }
 
 // =========================
@@ -37,55 +37,61 @@ FlowshopBlocking::FlowshopBlocking(const char* procTimeMatrixFile)
 }
 
 /**
- * @brief Initializes the completion time matrix (first column)
- * so that it is ready to be completed with the main algorithm.
- * Overrides method in base class.
+ * @brief Construct a new FlowshopBlocking object from an already loaded instance
  * 
- * @param compTimeMatrix Pointer to completion time matrix
- * @param seq Pointer to job sequence
- * @param rows Number of rows (machines) in the completion time matrix
- * @param cols Number of columns (jobs) in the completion time matrix
+ * @param _instance Shared pointer to the instance containing the job processing times matrix
  */
-void FlowshopBlocking::initTimeMatrix(int** departTimeMatrix, int* seq, size_t rows, size_t cols)
+FlowshopBlocking::FlowshopBlocking(InstancePtr _instance)
+    : FlowshopBasic(_instance)
 {
-    departTimeMatrix[0][0] = procTimeMatrix[0][seq[0] - 1];
+}
 
-    for (size_t r = 1; r < rows; r++)
-    {
-        departTimeMatrix[r][0] = procTimeMatrix[r][seq[0] - 1] + departTimeMatrix[r - 1][0];
-    }
+/**
+ * @brief Returns a new FlowshopBlocking object sharing the same instance.
+ * Overrides method in base class.
+ */
+FlowshopBasic* FlowshopBlocking::clone() const
+{
+    return new FlowshopBlocking(instance);
 }
 
 /**
- * @brief Calculates all remaining start and completion times for the current flowshop problem.
+ * @brief Calculates the departure times of a single job on every machine. A job
+ * cannot leave a machine until the previous job has left the next machine.
  * Overrides method in base class.
  * 
- * @param compTimeMatrix Pointer to completion time matrix
+ * @param prevDepart Departure times of the previous job in the sequence. Unused for the first job.
+ * @param curDepart Out array that receives the departure times of the current job
  * @param seq Pointer to job sequence
- * @param rows Number of rows (machines) in the completion time matrix
- * @param cols Number of columns (jobs) in the completion time matrix
+ * @param col Position of the current job in the sequence
  */
-void FlowshopBlocking::calcTimeMatrix(int** departTimeMatrix, int* seq, size_t rows, size_t cols)
+void FlowshopBlocking::calcDepartCol(const int* prevDepart, int* curDepart, const int* seq, size_t col) const
 {
-    for (size_t c = 1; c < cols; c++)
+    const size_t rows = ptMatrixRows;
+
+    // The first job is never blocked, and a single machine cannot block
+    if (col == 0 || rows == 1)
     {
-        int d1 = departTimeMatrix[0][c - 1] + procTimeMatrix[0][seq[c] - 1];
-        int d2 = departTimeMatrix[1][c - 1];
+        FlowshopBasic::calcDepartCol(prevDepart, curDepart, seq, col);
+        return;
+    }
 
-        departTimeMatrix[0][c] = max(d1, d2);
+    const int* jobTimes = jobTimeMatrix[seq[col] - 1];
 
-        for (size_t r = 1; r < rows - 1; r++)
-        {
-            int d1 = departTimeMatrix[r - 1][c] + procTimeMatrix[r][seq[c] - 1];
-            int d2 = departTimeMatrix[r + 1][c - 1];
+    int d1 = prevDepart[0] + jobTimes[0];
+    int d2 = prevDepart[1];
 
-            departTimeMatrix[r][c] = max(d1, d2);
-        }
+    curDepart[0] = max(d1, d2);
 
-        departTimeMatrix[rows - 1][c] = departTimeMatrix[rows - 2][c] + procTimeMatrix[rows - 1][seq[c] - 1];
+    for (size_t r = 1; r < rows - 1; r++)
+    {
+        int d1 = curDepart[r - 1] + jobTimes[r];
+        int d2 = prevDepart[r + 1];
 
-        FlowshopBasic::calcStartTimeCol(startTimeMatrix, departTimeMatrix, seq, c, rows, cols);
+        curDepart[r] = max(d1, d2);
     }
+
+    curDepart[rows - 1] = curDepart[rows - 2] + jobTimes[rows - 1];
 }
 
 // =========================
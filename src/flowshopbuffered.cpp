@@ -0,0 +1,268 @@
+/**
+ * @file flowshopbuffered.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the FlowshopBuffered class
+ * @version 0.1
+ * @date 2019-06-08
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include "flowshopbuffered.h"
+#include "instancecache.h"
+#include "fileview.h"
+#include "mem.h"
+
+using namespace fshop;
+
+const int FlowshopBuffered::UNLIMITED;
+
+/**
+ * @brief Simple inline helper function that returns the max of two integers
+ * 
+ * @param val1 First integer
+ * @param val2 Second integer
+ * @return Returns the maximum of the two integers
+ */
+inline int max(int val1, int val2)
+{
+    if (val1 >= val2) return val1;
+    else return val2;
+}
+
+/**
+ * @brief Construct a new FlowshopBuffered object. The processing times are loaded through
+ * the instance cache, and the buffer sizes from the buffers section of the same file.
+ * 
+ * @param procTimeMatrixFile File path to the data set file with buffer sizes
+ */
+FlowshopBuffered::FlowshopBuffered(const char* procTimeMatrixFile)
+    : FlowshopBuffered(InstanceCache::global().get(procTimeMatrixFile), loadBufferSizes(procTimeMatrixFile))
+{
+}
+
+/**
+ * @brief Construct a new FlowshopBuffered object from an already loaded instance
+ * 
+ * @param _instance Shared pointer to the instance containing the job processing times matrix
+ * @param _bufferSizes Either one size for every buffer, or the size of the buffer after each
+ * machine but the last. UNLIMITED is a buffer without limit.
+ */
+FlowshopBuffered::FlowshopBuffered(InstancePtr _instance, const std::vector<int>& _bufferSizes)
+    : FlowshopBasic(_instance), bufferSizes(_bufferSizes), ringColumns(2)
+{
+    const size_t buffers = ptMatrixRows - 1;
+
+    if (bufferSizes.size() == 1)
+        bufferSizes.assign(buffers, _bufferSizes[0]);
+    else if (bufferSizes.size() != buffers)
+        throw std::invalid_argument("Error: There must be one buffer size, or one per machine but the last");
+
+    // A buffer that can hold every job behind the first never fills up
+    size_t lagMax = 0;
+    for (size_t k = 0; k < buffers; k++)
+    {
+        const int size = bufferSizes[k];
+        if (size < UNLIMITED)
+            throw std::invalid_argument("Error: Buffer sizes cannot be negative");
+
+        if (size != UNLIMITED && static_cast<size_t>(size) + 1 < ptMatrixCols)
+            lagMax = std::max(lagMax, static_cast<size_t>(size) + 1);
+    }
+
+    // The ring must also hold the previous column while the current one is calculated
+    ringColumns = std::max<size_t>(lagMax, 2);
+
+    // While column c is in ring column c % R, machine k waits on the departure of job
+    // c - b - 1 from machine k + 1, which is still in ring column (c - b - 1) % R.
+    // Unlimited buffers wait on the zero after the ring.
+    lagIndex.resize(ringColumns * buffers);
+    for (size_t head = 0; head < ringColumns; head++)
+    {
+        for (size_t k = 0; k < buffers; k++)
+        {
+            const size_t lag = static_cast<size_t>(bufferSizes[k]) + 1;
+            const bool limited = bufferSizes[k] != UNLIMITED && lag < ptMatrixCols;
+            const size_t lagged = limited ? (head + ringColumns - lag) % ringColumns : 0;
+
+            lagIndex[head * buffers + k] = static_cast<int>(limited ? lagged * ptMatrixRows + k + 1 : ringColumns * ptMatrixRows);
+        }
+    }
+}
+
+/**
+ * @brief Returns the size of the buffer after each machine but the last
+ * 
+ * @return Returns m - 1 buffer sizes, UNLIMITED for a buffer without limit
+ */
+const std::vector<int>& FlowshopBuffered::getBufferSizes() const
+{
+    return bufferSizes;
+}
+
+/**
+ * @brief Loads the buffer sizes section of a data set file
+ * 
+ * @param filePath Path to the file
+ * @return Returns the buffer sizes as listed in the file. Throws std::runtime_error on error.
+ */
+std::vector<int> FlowshopBuffered::loadBufferSizes(const char* filePath)
+{
+    util::FileView file;
+    if (!file.open(filePath))
+        throw std::runtime_error(std::string("Error opening buffer sizes file: ") + filePath);
+
+    const char* p = file.data();
+    const char* const end = p + file.size();
+
+    while (p < end && !util::isKeywordLine(p, end, "buffers"))
+        p = util::skipLine(p, end);
+
+    if (p >= end)
+        throw std::runtime_error(std::string("Error: File has no buffer sizes: ") + filePath);
+
+    p = util::skipLine(p, end);
+
+    std::vector<int> sizes;
+    if (!util::readIntLine(p, end, sizes) || sizes.empty())
+        throw std::runtime_error(std::string("Error: Buffer sizes are missing or invalid: ") + filePath);
+
+    return sizes;
+}
+
+/**
+ * @brief Parses buffer sizes as written in parameter files, separated by commas or
+ * spaces. Each size is a non-negative integer, or "inf" for an unlimited buffer.
+ * 
+ * @param text Text to parse, such as "2" or "1,inf,0"
+ * @param out Out reference that receives the buffer sizes
+ * @return Returns true if every size is valid. Otherwise false.
+ */
+bool FlowshopBuffered::parseBufferSizes(const std::string& text, std::vector<int>& out)
+{
+    std::string spaced = text;
+    for (auto& ch : spaced)
+    {
+        if (ch == ',') ch = ' ';
+    }
+
+    std::stringstream ss(spaced);
+    std::string token;
+    std::vector<int> sizes;
+
+    while (ss >> token)
+    {
+        if (token == "inf")
+        {
+            sizes.push_back(UNLIMITED);
+            continue;
+        }
+
+        char* tokenEnd = nullptr;
+        const long size = std::strtol(token.c_str(), &tokenEnd, 10);
+        if (*tokenEnd != '\0' || size < UNLIMITED || size > 1000000)
+            return false;
+
+        sizes.push_back(static_cast<int>(size));
+    }
+
+    if (sizes.empty())
+        return false;
+
+    out = sizes;
+    return true;
+}
+
+/**
+ * @brief Returns a new FlowshopBuffered object sharing the same instance and buffer sizes.
+ * Overrides method in base class.
+ */
+FlowshopBasic* FlowshopBuffered::clone() const
+{
+    return new FlowshopBuffered(instance, bufferSizes);
+}
+
+/**
+ * @brief Returns the number of ints of column buffer needed by calcTimes(): the
+ * ring of departure columns and the zero that unlimited buffers wait on.
+ * Overrides method in base class.
+ */
+size_t FlowshopBuffered::getScratchSize() const
+{
+    return ringColumns * ptMatrixRows + 1;
+}
+
+/**
+ * @brief Calculates the departure times one column (job) at a time, and returns the objective values.
+ * A job starts on a machine once it has left the previous machine and the previous job has left
+ * this one, and it leaves once it is done and the next buffer has room. Columns are kept in a
+ * ring of the last R columns, where the previous column and the departure of the job b + 1
+ * places back are found. The ring starts out zeroed, so the first b + 1 jobs are never blocked.
+ * Overrides method in base class.
+ * 
+ * @param seq Pointer to job sequence
+ * @param seqSize Size of the job sequence
+ * @param colBuffer Buffer of getScratchSize() ints for the ring of columns
+ * @param startTimeMatrix Start times matrix to fill, or nullptr
+ * @param departTimeMatrix Departure times matrix to fill, or nullptr
+ * @return Returns the objective values of the job sequence
+ */
+ObjectiveValue FlowshopBuffered::calcTimes(const int* seq, size_t seqSize, int* colBuffer, int** startTimeMatrix, int** departTimeMatrix) const
+{
+    const size_t rows = ptMatrixRows;
+    const size_t last = rows - 1;
+    int* const ring = colBuffer;
+
+    // Every machine is free at time zero
+    std::fill(ring, ring + ringColumns * rows + 1, 0);
+
+    ObjectiveValue value = initialValue();
+    size_t head = 0;
+    const int* prevDepart = ring + (ringColumns - 1) * rows;
+
+    for (size_t c = 0; c < seqSize; c++)
+    {
+        const int* jobTimes = jobTimeMatrix[seq[c] - 1];
+        const int* lag = lagIndex.data() + head * last;
+        int* curDepart = ring + head * rows;
+        int arrival = 0;
+
+        // Blocked until the job b + 1 places back has left the next machine. Only the
+        // arrival from the previous machine depends on the last step, so everything
+        // else is combined first to keep the dependency chain as short as blocking's.
+        for (size_t r = 0; r < last; r++)
+        {
+            const int ready = max(prevDepart[r] + jobTimes[r], ring[lag[r]]);
+            arrival = max(arrival + jobTimes[r], ready);
+            curDepart[r] = arrival;
+        }
+
+        curDepart[last] = max(arrival, prevDepart[last]) + jobTimes[last];
+        addCompletion(value, seq[c], curDepart[last]);
+
+        if (departTimeMatrix != nullptr)
+        {
+            for (size_t r = 0; r < rows; r++)
+            {
+                departTimeMatrix[r][c] = curDepart[r];
+                startTimeMatrix[r][c] = curDepart[r] - jobTimes[r];
+            }
+        }
+
+        prevDepart = curDepart;
+        if (++head == ringColumns)
+            head = 0;
+    }
+
+    value.cmax = prevDepart[last];
+    return value;
+}
+
+// =========================
+// End of flowshopbuffered.cpp
+// =========================
@@ -40,58 +40,64 @@ FlowshopNoWait::FlowshopNoWait(const char* procTimeMatrixFile)
 }
 
 /**
- * @brief Initializes the completion time matrix (first column)
- * so that it is ready to be completed with the main algorithm.
- * Overrides method in base class.
+ * @brief Construct a new FlowshopNoWait object from an already loaded instance
  * 
- * @param compTimeMatrix Pointer to completion time matrix
- * @param seq Pointer to job sequence
- * @param rows Number of rows (machines) in the completion time matrix
- * @param cols Number of columns (jobs) in the completion time matrix
+ * @param _instance Shared pointer to the instance containing the job processing times matrix
  */
-void FlowshopNoWait::initTimeMatrix(int** departTimeMatrix, int* seq, size_t rows, size_t cols)
+FlowshopNoWait::FlowshopNoWait(InstancePtr _instance)
+    : FlowshopBasic(_instance)
 {
-    departTimeMatrix[0][0] = procTimeMatrix[0][seq[0] - 1];
+}
 
-    for (size_t r = 1; r < rows; r++)
-    {
-        departTimeMatrix[r][0] = procTimeMatrix[r][seq[0] - 1] + departTimeMatrix[r - 1][0];
-    }
+/**
+ * @brief Returns a new FlowshopNoWait object sharing the same instance.
+ * Overrides method in base class.
+ */
+FlowshopBasic* FlowshopNoWait::clone() const
+{
+    return new FlowshopNoWait(instance);
 }
 
 /**
- * @brief Calculates all remaining start and completion times for the current flowshop problem.
+ * @brief Calculates the departure times of a single job on every machine. A job
+ * must move to the next machine as soon as it finishes, so its start is delayed
+ * on every earlier machine whenever a later machine is still busy.
  * Overrides method in base class.
  * 
- * @param compTimeMatrix Pointer to completion time matrix
+ * @param prevDepart Departure times of the previous job in the sequence. Unused for the first job.
+ * @param curDepart Out array that receives the departure times of the current job
  * @param seq Pointer to job sequence
- * @param rows Number of rows (machines) in the completion time matrix
- * @param cols Number of columns (jobs) in the completion time matrix
+ * @param col Position of the current job in the sequence
  */
-void FlowshopNoWait::calcTimeMatrix(int** departTimeMatrix, int* seq, size_t rows, size_t cols)
+void FlowshopNoWait::calcDepartCol(const int* prevDepart, int* curDepart, const int* seq, size_t col) const
 {
-    for (size_t c = 1; c < cols; c++)
+    // The first job never waits
+    if (col == 0)
     {
-        departTimeMatrix[0][c] = departTimeMatrix[0][c - 1] + procTimeMatrix[0][seq[c] - 1];
+        FlowshopBasic::calcDepartCol(prevDepart, curDepart, seq, col);
+        return;
+    }
 
-        for (size_t r = 1; r < rows; r++)
-        {
-            int d1 = departTimeMatrix[r - 1][c];
-            int d2 = departTimeMatrix[r][c - 1];
+    const size_t rows = ptMatrixRows;
+    const int* jobTimes = jobTimeMatrix[seq[col] - 1];
 
-            if (d1 < d2)
-            {
-                const int diff = d2 - d1;
-                for (size_t r2 = r + 1; r2 > 0; r2--)
-                    departTimeMatrix[r2 - 1][c] += diff;
+    curDepart[0] = prevDepart[0] + jobTimes[0];
 
-                d1 = departTimeMatrix[r - 1][c];
-            }
+    for (size_t r = 1; r < rows; r++)
+    {
+        int d1 = curDepart[r - 1];
+        int d2 = prevDepart[r];
+
+        if (d1 < d2)
+        {
+            const int diff = d2 - d1;
+            for (size_t r2 = r; r2 > 0; r2--)
+                curDepart[r2 - 1] += diff;
 
-            departTimeMatrix[r][c] = d1 + procTimeMatrix[r][seq[c] - 1];
+            d1 = curDepart[r - 1];
         }
 
-        FlowshopBasic::calcStartTimeCol(startTimeMatrix, departTimeMatrix, seq, c, rows, cols);
+        curDepart[r] = d1 + jobTimes[r];
     }
 }
 
@@ -0,0 +1,119 @@
+/**
+ * @file flowshopsdst.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the FlowshopSDST class
+ * @version 0.1
+ * @date 2019-06-06
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <stdexcept>
+#include "flowshopsdst.h"
+#include "instancecache.h"
+
+using namespace fshop;
+
+/**
+ * @brief Simple inline helper function that returns the max of two integers
+ * 
+ * @param val1 First integer
+ * @param val2 Second integer
+ * @return Returns the maximum of the two integers
+ */
+inline int max(int val1, int val2)
+{
+    if (val1 >= val2) return val1;
+    else return val2;
+}
+
+/**
+ * @brief Construct a new FlowshopSDST object. The processing times are loaded through
+ * the instance cache, and the setup times from the blocks that follow them in the file.
+ * 
+ * @param procTimeMatrixFile File path to the data set file with setup times
+ */
+FlowshopSDST::FlowshopSDST(const char* procTimeMatrixFile)
+    : FlowshopSDST(InstanceCache::global().get(procTimeMatrixFile), SetupTimes::loadFromFile(procTimeMatrixFile))
+{
+}
+
+/**
+ * @brief Construct a new FlowshopSDST object from an already loaded instance and setup times
+ * 
+ * @param _instance Shared pointer to the instance containing the job processing times matrix
+ * @param _setupTimes Shared pointer to the setup times of the same instance
+ */
+FlowshopSDST::FlowshopSDST(InstancePtr _instance, SetupTimesPtr _setupTimes)
+    : FlowshopBasic(_instance), setupTimes(_setupTimes)
+{
+    if (setupTimes == nullptr)
+        throw std::invalid_argument("Error: _setupTimes cannot be nullptr");
+    else if (setupTimes->getTotalMachines() != ptMatrixRows || setupTimes->getTotalJobs() != ptMatrixCols)
+        throw std::invalid_argument("Error: Setup times do not match the size of the processing time matrix: " + setupTimes->getFilePath());
+}
+
+/**
+ * @brief Returns the setup times shared by this flowshop
+ * 
+ * @return Returns a shared pointer to the setup times
+ */
+SetupTimesPtr FlowshopSDST::getSetupTimes() const
+{
+    return setupTimes;
+}
+
+/**
+ * @brief Returns a new FlowshopSDST object sharing the same instance and setup times.
+ * Overrides method in base class.
+ */
+FlowshopBasic* FlowshopSDST::clone() const
+{
+    return new FlowshopSDST(instance, setupTimes);
+}
+
+/**
+ * @brief Calculates the departure times of a single job on every machine. The setup for
+ * the job starts when the previous job leaves the machine, and processing starts once both
+ * the setup is done and the job has left the previous machine.
+ * Overrides method in base class.
+ * 
+ * @param prevDepart Departure times of the previous job in the sequence. Unused for the first job.
+ * @param curDepart Out array that receives the departure times of the current job
+ * @param seq Pointer to job sequence
+ * @param col Position of the current job in the sequence
+ */
+void FlowshopSDST::calcDepartCol(const int* prevDepart, int* curDepart, const int* seq, size_t col) const
+{
+    const size_t rows = ptMatrixRows;
+    const size_t job = seq[col] - 1;
+    const int* jobTimes = jobTimeMatrix[job];
+
+    // The first job only waits for its initial setup
+    if (col == 0)
+    {
+        const int* setup = setupTimes->getSetupTimes(job, job);
+        curDepart[0] = setup[0] + jobTimes[0];
+
+        for (size_t r = 1; r < rows; r++)
+            curDepart[r] = max(curDepart[r - 1], setup[r]) + jobTimes[r];
+
+        return;
+    }
+
+    const int* setup = setupTimes->getSetupTimes(seq[col - 1] - 1, job);
+    curDepart[0] = prevDepart[0] + setup[0] + jobTimes[0];
+
+    for (size_t r = 1; r < rows; r++)
+    {
+        int c1 = curDepart[r - 1];
+        int c2 = prevDepart[r] + setup[r];
+
+        curDepart[r] = max(c1, c2) + jobTimes[r];
+    }
+}
+
+// =========================
+// End of flowshopsdst.cpp
+// =========================
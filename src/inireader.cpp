@@ -72,6 +72,22 @@ bool IniReader::entryExists(std::string section, std::string entry)
     return it->second.find(entry) != it->second.end();
 }
 
+/**
+ * @brief Returns the names of all sections in the current ini file,
+ * sorted alphabetically.
+ * 
+ * @return Returns a vector containing all section names
+ */
+std::vector<std::string> IniReader::getSectionNames()
+{
+    std::vector<std::string> names;
+
+    for (auto& section : iniMap)
+        names.push_back(section.first);
+
+    return names;
+}
+
 /**
  * @brief Returns the value for the entry that has the given entry key
  * within the given section
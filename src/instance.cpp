@@ -0,0 +1,240 @@
+/**
+ * @file instance.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the Instance class.
+ * @version 0.1
+ * @date 2019-05-28
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <fstream>
+#include <stdexcept>
+#include "instance.h"
+#include "mem.h"
+
+using namespace fshop;
+
+/**
+ * @brief Constructs a new Instance object
+ * 
+ * @param _procTimeMatrix Pointer to the processing time matrix. This class takes ownership of the pointer and will destroy it.
+ * @param _rows Number of rows (machines) in the processing time matrix
+ * @param _cols Number of columns (jobs) in the processing time matrix
+ * @param _filePath Path of the file the matrix was loaded from
+ */
+Instance::Instance(int** _procTimeMatrix, size_t _rows, size_t _cols, const std::string& _filePath)
+    : ownedMatrix(_procTimeMatrix), ptMatrixRows(_rows), ptMatrixCols(_cols), filePath(_filePath)
+{
+    for (size_t r = 0; r < ptMatrixRows; r++)
+        rowPtrs.push_back(ownedMatrix[r]);
+
+    precompute();
+}
+
+/**
+ * @brief Constructs a new Instance object that views memory owned elsewhere
+ * 
+ * @param data Pointer to the processing times, stored row-major and contiguous
+ * @param _rows Number of rows (machines) in the processing time matrix
+ * @param _cols Number of columns (jobs) in the processing time matrix
+ * @param _filePath Name describing where the matrix came from
+ * @param _storage Object owning the memory data points into, kept alive by this instance
+ */
+Instance::Instance(const int* data, size_t _rows, size_t _cols, const std::string& _filePath, std::shared_ptr<const void> _storage)
+    : ownedMatrix(nullptr), storage(_storage), ptMatrixRows(_rows), ptMatrixCols(_cols), filePath(_filePath)
+{
+    for (size_t r = 0; r < ptMatrixRows; r++)
+        rowPtrs.push_back(data + r * ptMatrixCols);
+
+    precompute();
+}
+
+/**
+ * @brief Destroys the Instance object
+ */
+Instance::~Instance()
+{
+    util::releaseMatrix<int>(ownedMatrix, ptMatrixRows);
+}
+
+/**
+ * @brief Loads a new instance from a file containing a job processing time matrix
+ * 
+ * @param procTimeMatrixFile File path to the file containing the job processing times matrix
+ * @return Returns a shared pointer to the loaded instance
+ */
+InstancePtr Instance::loadFromFile(const char* procTimeMatrixFile)
+{
+    size_t rows = 0;
+    size_t cols = 0;
+
+    // Attempt to load job processing times from the given file
+    int** matrix = util::loadMatrixFromFile<int>(procTimeMatrixFile, rows, cols);
+    if (matrix == nullptr)
+    {
+        std::string msg = "Error when loading matrix file: ";
+        msg += procTimeMatrixFile;
+        throw std::runtime_error(msg);
+    }
+
+    return InstancePtr(new Instance(matrix, rows, cols, procTimeMatrixFile));
+}
+
+/**
+ * @brief Creates an instance that views an existing processing time matrix without copying it
+ * 
+ * @param data Pointer to the processing times, stored row-major and contiguous
+ * @param rows Number of rows (machines) in the processing time matrix
+ * @param cols Number of columns (jobs) in the processing time matrix
+ * @param name Name describing where the matrix came from
+ * @param storage Object owning the memory data points into. It is kept alive as long as the instance.
+ * @return Returns a shared pointer to the new instance
+ */
+InstancePtr Instance::createView(const int* data, size_t rows, size_t cols, const std::string& name, std::shared_ptr<const void> storage)
+{
+    if (data == nullptr || rows == 0 || cols == 0)
+        throw std::invalid_argument("Error: Instance view cannot be empty");
+
+    return InstancePtr(new Instance(data, rows, cols, name, storage));
+}
+
+/**
+ * @brief Reads only the matrix size from the first line of a data set file,
+ * without loading the processing times
+ * 
+ * @param procTimeMatrixFile Path to the data set file
+ * @param rows Out reference that receives the number of rows (machines)
+ * @param cols Out reference that receives the number of columns (jobs)
+ * @return Returns true if the size was read. Otherwise false.
+ */
+bool Instance::readFileHeader(const char* procTimeMatrixFile, size_t& rows, size_t& cols)
+{
+    std::ifstream file(procTimeMatrixFile);
+    rows = 0;
+    cols = 0;
+
+    return static_cast<bool>(file >> rows >> cols) && rows > 0 && cols > 0;
+}
+
+/**
+ * @brief Estimates the memory held by a loaded instance: the processing time
+ * matrix, its transposed copy, the row pointers and the per-job and per-machine
+ * totals. A view's matrix lives in the mapped file, but is counted as well
+ * because its pages become resident once read.
+ * 
+ * @param rows Number of rows (machines)
+ * @param cols Number of columns (jobs)
+ * @return Returns the estimate in bytes
+ */
+size_t Instance::estimateBytes(size_t rows, size_t cols)
+{
+    const size_t matrixBytes = rows * cols * sizeof(int);
+    const size_t pointerBytes = (rows + cols) * sizeof(int*);
+    const size_t totalsBytes = (rows + cols) * sizeof(int);
+
+    return 2 * matrixBytes + pointerBytes + totalsBytes + sizeof(Instance);
+}
+
+/**
+ * @brief Returns the total number of machines in the processing time matrix
+ * 
+ * @return Returns the total number of machines
+ */
+size_t Instance::getTotalMachines() const
+{
+    return ptMatrixRows;
+}
+
+/**
+ * @brief Returns the total number of jobs in the processing time matrix
+ * 
+ * @return Returns the total number of jobs
+ */
+size_t Instance::getTotalJobs() const
+{
+    return ptMatrixCols;
+}
+
+/**
+ * @brief Returns a read-only pointer to the processing time matrix
+ * 
+ * @return Returns the processing time matrix, indexed [machine][job]
+ */
+const int* const* Instance::getProcTimeMatrix() const
+{
+    return rowPtrs.data();
+}
+
+/**
+ * @brief Returns a read-only pointer to the transposed processing time matrix.
+ * Each row holds the processing times of one job on every machine, which keeps
+ * the times of a single job contiguous in memory.
+ * 
+ * @return Returns the transposed processing time matrix, indexed [job][machine]
+ */
+const int* const* Instance::getJobTimeMatrix() const
+{
+    return jobPtrs.data();
+}
+
+/**
+ * @brief Returns the total processing time of every job over all machines
+ * 
+ * @return Returns an array of job totals, indexed [job]
+ */
+const int* Instance::getJobTotals() const
+{
+    return jobTotals.data();
+}
+
+/**
+ * @brief Returns the total processing time of every machine over all jobs
+ * 
+ * @return Returns an array of machine totals, indexed [machine]
+ */
+const int* Instance::getMachineTotals() const
+{
+    return machineTotals.data();
+}
+
+/**
+ * @brief Returns the path of the file the instance was loaded from
+ * 
+ * @return Returns the file path
+ */
+const std::string& Instance::getFilePath() const
+{
+    return filePath;
+}
+
+/**
+ * @brief Computes all data derived from the processing time matrix.
+ * Called once by each constructor.
+ */
+void Instance::precompute()
+{
+    jobTimes.assign(ptMatrixRows * ptMatrixCols, 0);
+    jobTotals.assign(ptMatrixCols, 0);
+    machineTotals.assign(ptMatrixRows, 0);
+
+    for (size_t m = 0; m < ptMatrixRows; m++)
+    {
+        const int* row = rowPtrs[m];
+
+        for (size_t j = 0; j < ptMatrixCols; j++)
+        {
+            jobTimes[j * ptMatrixRows + m] = row[j];
+            jobTotals[j] += row[j];
+            machineTotals[m] += row[j];
+        }
+    }
+
+    for (size_t j = 0; j < ptMatrixCols; j++)
+        jobPtrs.push_back(jobTimes.data() + j * ptMatrixRows);
+}
+
+// =========================
+// End of instance.cpp
+// =========================
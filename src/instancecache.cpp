@@ -0,0 +1,172 @@
+/**
+ * @file instancecache.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the InstanceCache class.
+ * @version 0.1
+ * @date 2019-05-29
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "instancecache.h"
+
+using namespace fshop;
+
+/**
+ * @brief Reads the modification time and size of a regular file
+ * 
+ * @param filePath Path to the file
+ * @param outModTime Out reference that receives the modification time
+ * @param outSize Out reference that receives the file size
+ * @return Returns true if the file exists and is a regular file
+ */
+static bool getFileVersion(const std::string& filePath, long long& outModTime, long long& outSize)
+{
+    struct stat st;
+    if (stat(filePath.c_str(), &st) != 0 || (st.st_mode & S_IFMT) != S_IFREG)
+        return false;
+
+    outModTime = static_cast<long long>(st.st_mtime);
+    outSize = static_cast<long long>(st.st_size);
+    return true;
+}
+
+/**
+ * @brief Construct a new InstanceCache object
+ * 
+ * @param _capacity Maximum number of instances kept in the cache
+ */
+InstanceCache::InstanceCache(size_t _capacity)
+    : capacity(_capacity), hits(0), misses(0)
+{
+}
+
+/**
+ * @brief Returns the process-wide instance cache
+ * 
+ * @return Returns a reference to the global cache
+ */
+InstanceCache& InstanceCache::global()
+{
+    static InstanceCache cache;
+    return cache;
+}
+
+/**
+ * @brief Returns the instance for the given file, loading it if it is not cached
+ * or if the file changed since it was cached. Files that are not regular files,
+ * such as pipes, are loaded every time and never cached.
+ * 
+ * @param filePath Path to the file containing the job processing times matrix
+ * @return Returns a shared pointer to the instance. Throws std::runtime_error on load errors.
+ */
+InstancePtr InstanceCache::get(const std::string& filePath)
+{
+    long long modTime = 0;
+    long long fileSize = 0;
+
+    if (!getFileVersion(filePath, modTime, fileSize))
+        return Instance::loadFromFile(filePath.c_str());
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        auto it = lookup.find(filePath);
+        if (it != lookup.end() && it->second->modTime == modTime && it->second->fileSize == fileSize)
+        {
+            // Move entry to the front of the LRU list
+            entries.splice(entries.begin(), entries, it->second);
+            hits++;
+            return it->second->instance;
+        }
+
+        misses++;
+    }
+
+    // Load outside of the lock, so different files can be parsed in parallel
+    InstancePtr instance = Instance::loadFromFile(filePath.c_str());
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto it = lookup.find(filePath);
+    if (it != lookup.end())
+    {
+        entries.erase(it->second);
+        lookup.erase(it);
+    }
+
+    entries.push_front({ filePath, modTime, fileSize, instance });
+    lookup[filePath] = entries.begin();
+    evict();
+
+    return instance;
+}
+
+/**
+ * @brief Removes all instances from the cache. Instances still in use elsewhere stay alive.
+ */
+void InstanceCache::clear()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    entries.clear();
+    lookup.clear();
+}
+
+/**
+ * @brief Sets the maximum number of cached instances, evicting entries if needed
+ * 
+ * @param _capacity Maximum number of instances. Zero disables caching.
+ */
+void InstanceCache::setCapacity(size_t _capacity)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    capacity = _capacity;
+    evict();
+}
+
+/**
+ * @brief Returns the maximum number of cached instances
+ */
+size_t InstanceCache::getCapacity()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return capacity;
+}
+
+/**
+ * @brief Returns the number of requests served from the cache
+ */
+size_t InstanceCache::getHits()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return hits;
+}
+
+/**
+ * @brief Returns the number of requests that had to load the file
+ */
+size_t InstanceCache::getMisses()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return misses;
+}
+
+/**
+ * @brief Evicts least recently used entries until the cache is within capacity.
+ * Must be called with the lock held.
+ */
+void InstanceCache::evict()
+{
+    while (entries.size() > capacity)
+    {
+        lookup.erase(entries.back().filePath);
+        entries.pop_back();
+    }
+}
+
+// =========================
+// End of instancecache.cpp
+// =========================
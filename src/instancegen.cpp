@@ -0,0 +1,169 @@
+/**
+ * @file instancegen.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the InstanceGenerator class.
+ * @version 0.1
+ * @date 2019-05-31
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <stdexcept>
+#include "instancegen.h"
+
+using namespace fshop;
+
+/**
+ * @brief Converts a distribution name into a GenDistribution.
+ * Accepted names are "uniform", "jobcorr" and "machcorr".
+ * 
+ * @param name Name of the distribution
+ * @param out Out reference that receives the distribution
+ * @return Returns true if the name is known. Otherwise false.
+ */
+bool fshop::parseGenDistribution(const std::string& name, GenDistribution& out)
+{
+    if (name == "uniform")
+        out = GEN_UNIFORM;
+    else if (name == "jobcorr")
+        out = GEN_JOB_CORRELATED;
+    else if (name == "machcorr")
+        out = GEN_MACHINE_CORRELATED;
+    else
+        return false;
+
+    return true;
+}
+
+// ============================================================
+
+/**
+ * @brief Construct a new TaillardRandom object
+ * 
+ * @param _seed Initial seed, in [1, 2^31 - 2]
+ */
+TaillardRandom::TaillardRandom(int32_t _seed)
+    : seed(_seed)
+{
+    if (seed <= 0 || seed == 2147483647)
+        throw std::invalid_argument("Error: seed must be in [1, 2147483646]");
+}
+
+/**
+ * @brief Returns the next random integer, uniformly distributed in [low, high]
+ * 
+ * @param low Smallest value
+ * @param high Largest value
+ * @return Returns the random integer
+ */
+int TaillardRandom::unif(int low, int high)
+{
+    static const int32_t m = 2147483647, a = 16807, b = 127773, c = 2836;
+
+    // Schrage's method computes (a * seed) mod m without overflow
+    const int32_t k = seed / b;
+    seed = a * (seed % b) - k * c;
+    if (seed < 0) seed += m;
+
+    const double value01 = static_cast<double>(seed) / m;
+    return low + static_cast<int>(value01 * (high - low + 1));
+}
+
+/**
+ * @brief Returns the current generator state
+ */
+int32_t TaillardRandom::getSeed() const
+{
+    return seed;
+}
+
+// ============================================================
+
+/**
+ * @brief Construct a new InstanceGenerator object
+ * 
+ * @param _jobs Number of jobs (columns) per machine row
+ * @param _machines Number of machines (rows)
+ * @param seed Seed of the random number generator
+ * @param _distribution Processing time distribution
+ * @param _minTime Smallest processing time
+ * @param _maxTime Largest processing time
+ */
+InstanceGenerator::InstanceGenerator(size_t _jobs, size_t _machines, int32_t seed, GenDistribution _distribution, int _minTime, int _maxTime)
+    : rand(seed), jobs(_jobs), machines(_machines), distribution(_distribution), minTime(_minTime), maxTime(_maxTime), spread(0)
+{
+    if (jobs == 0 || machines == 0)
+        throw std::invalid_argument("Error: jobs and machines cannot be zero");
+    else if (minTime < 0 || maxTime < minTime)
+        throw std::invalid_argument("Error: processing time range is invalid");
+
+    // Correlated times vary by up to a tenth of the range around their base
+    spread = (maxTime - minTime) / 10;
+    if (spread < 1) spread = 1;
+
+    if (distribution == GEN_JOB_CORRELATED)
+    {
+        jobBase.resize(jobs);
+        for (size_t j = 0; j < jobs; j++)
+            jobBase[j] = rand.unif(minTime, maxTime);
+    }
+}
+
+/**
+ * @brief Generates the processing times of the next machine
+ * 
+ * @param row Out array of getTotalJobs() processing times
+ */
+void InstanceGenerator::nextRow(int* row)
+{
+    if (distribution == GEN_JOB_CORRELATED)
+    {
+        for (size_t j = 0; j < jobs; j++)
+            row[j] = correlated(jobBase[j]);
+    }
+    else if (distribution == GEN_MACHINE_CORRELATED)
+    {
+        const int machineBase = rand.unif(minTime, maxTime);
+        for (size_t j = 0; j < jobs; j++)
+            row[j] = correlated(machineBase);
+    }
+    else
+    {
+        for (size_t j = 0; j < jobs; j++)
+            row[j] = rand.unif(minTime, maxTime);
+    }
+}
+
+/**
+ * @brief Returns the number of jobs in every row
+ */
+size_t InstanceGenerator::getTotalJobs() const
+{
+    return jobs;
+}
+
+/**
+ * @brief Returns the number of machine rows in the instance
+ */
+size_t InstanceGenerator::getTotalMachines() const
+{
+    return machines;
+}
+
+/**
+ * @brief Returns a random time near the given base time, clamped to [minTime, maxTime]
+ */
+int InstanceGenerator::correlated(int base)
+{
+    int val = base + rand.unif(-spread, spread);
+
+    if (val < minTime) val = minTime;
+    else if (val > maxTime) val = maxTime;
+
+    return val;
+}
+
+// =========================
+// End of instancegen.cpp
+// =========================
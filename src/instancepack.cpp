@@ -0,0 +1,407 @@
+/**
+ * @file instancepack.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the InstancePack class.
+ * @version 0.1
+ * @date 2019-05-28
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include "instancepack.h"
+#include "mem.h"
+
+#define PACK_MAGIC       "FSHPACK"
+#define PACK_VERSION     1
+#define PACK_HEADER_SIZE 32
+#define PACK_ENTRY_SIZE  32
+#define PACK_ALIGN       64
+
+using namespace fshop;
+
+/**
+ * @brief Returns true if the host stores integers in little-endian byte order
+ */
+static bool hostIsLittleEndian()
+{
+    const uint16_t val = 1;
+    unsigned char firstByte = 0;
+    std::memcpy(&firstByte, &val, 1);
+    return firstByte == 1;
+}
+
+/**
+ * @brief Decodes a little-endian unsigned integer of the given byte width
+ */
+static uint64_t readLE(const char* p, size_t bytes)
+{
+    uint64_t val = 0;
+    for (size_t i = 0; i < bytes; i++)
+        val |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+
+    return val;
+}
+
+/**
+ * @brief Writes an unsigned integer of the given byte width to a stream in little-endian order
+ */
+static void writeLE(std::ostream& os, uint64_t val, size_t bytes)
+{
+    char buf[8];
+    for (size_t i = 0; i < bytes; i++)
+        buf[i] = static_cast<char>((val >> (8 * i)) & 0xFF);
+
+    os.write(buf, bytes);
+}
+
+/**
+ * @brief Rounds an offset up to the next multiple of PACK_ALIGN
+ */
+static uint64_t alignOffset(uint64_t offset)
+{
+    return (offset + PACK_ALIGN - 1) / PACK_ALIGN * PACK_ALIGN;
+}
+
+/**
+ * @brief Opens and validates a pack file. Throws std::runtime_error on error.
+ * 
+ * @param packFile Path to the pack file
+ */
+InstancePack::InstancePack(const char* packFile)
+    : filePath(packFile)
+{
+    if (!file.open(packFile))
+        throw std::runtime_error(std::string("Error opening instance pack: ") + packFile);
+
+    const char* data = file.data();
+    const uint64_t size = file.size();
+
+    if (size < PACK_HEADER_SIZE || std::memcmp(data, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0)
+        throw std::runtime_error(std::string("Error: Not an instance pack: ") + packFile);
+    else if (readLE(data + 8, 4) != PACK_VERSION)
+        throw std::runtime_error(std::string("Error: Unsupported instance pack version: ") + packFile);
+
+    const uint64_t count = readLE(data + 12, 4);
+    const uint64_t indexOffset = readLE(data + 16, 8);
+
+    if (indexOffset > size || count > (size - indexOffset) / PACK_ENTRY_SIZE)
+        throw std::runtime_error(std::string("Error: Instance pack index is truncated: ") + packFile);
+
+    // Read and validate the index
+    for (uint64_t i = 0; i < count; i++)
+    {
+        const char* e = data + indexOffset + i * PACK_ENTRY_SIZE;
+
+        PackEntry entry;
+        entry.id = static_cast<int32_t>(static_cast<uint32_t>(readLE(e, 4)));
+        entry.jobs = static_cast<size_t>(readLE(e + 4, 4));
+        entry.machines = static_cast<size_t>(readLE(e + 8, 4));
+        entry.offset = readLE(e + 16, 8);
+
+        const uint64_t bytes = static_cast<uint64_t>(entry.jobs) * entry.machines * sizeof(int32_t);
+
+        if (entry.jobs == 0 || entry.machines == 0 || entry.offset % PACK_ALIGN != 0 ||
+            entry.offset > size || bytes > size - entry.offset)
+        {
+            throw std::runtime_error(std::string("Error: Instance pack entry is invalid: ") + packFile);
+        }
+
+        entries.push_back(entry);
+    }
+}
+
+/**
+ * @brief Opens a pack file and maps it into memory
+ * 
+ * @param packFile Path to the pack file
+ * @return Returns a shared pointer to the opened pack. Throws std::runtime_error on error.
+ */
+std::shared_ptr<InstancePack> InstancePack::open(const char* packFile)
+{
+    return std::shared_ptr<InstancePack>(new InstancePack(packFile));
+}
+
+/**
+ * @brief Converts a range of text instance files into a new pack file
+ * 
+ * @param packFile Path of the pack file to create
+ * @param inputFilesDir Directory containing the [NUM].txt instance files
+ * @param minId Number of the first instance file
+ * @param maxId Number of the last instance file
+ * @return Returns true on success. Otherwise false.
+ */
+bool InstancePack::create(const char* packFile, const std::string& inputFilesDir, int minId, int maxId)
+{
+    using namespace std;
+
+    if (maxId < minId)
+    {
+        cerr << "Error: Instance range is empty." << endl;
+        return false;
+    }
+
+    // Load all instances first, so the index can be written up front
+    vector<InstancePtr> instances;
+    vector<PackEntry> packEntries;
+
+    for (int id = minId; id <= maxId; id++)
+    {
+        string inputFile = inputFilesDir + to_string(id) + ".txt";
+
+        InstancePtr inst;
+        try
+        {
+            inst = Instance::loadFromFile(inputFile.c_str());
+        }
+        catch(const std::exception& e)
+        {
+            cerr << e.what() << endl;
+            return false;
+        }
+
+        PackEntry entry;
+        entry.id = id;
+        entry.jobs = inst->getTotalJobs();
+        entry.machines = inst->getTotalMachines();
+        entry.offset = 0;
+
+        packEntries.push_back(entry);
+        instances.push_back(inst);
+    }
+
+    InstancePackWriter writer;
+    if (!writer.open(packFile, packEntries))
+    {
+        cerr << "Error: Unable to create instance pack: " << packFile << endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < instances.size(); i++)
+    {
+        const int* const* matrix = instances[i]->getProcTimeMatrix();
+        for (size_t m = 0; m < packEntries[i].machines; m++)
+            writer.writeRow(matrix[m], packEntries[i].jobs);
+    }
+
+    return writer.close();
+}
+
+/**
+ * @brief Returns true if the given path names a pack file, which is
+ * recognised by its .pack extension
+ * 
+ * @param path File or directory path
+ * @return Returns true if the path ends with ".pack"
+ */
+bool InstancePack::isPackFile(const std::string& path)
+{
+    const std::string ext = ".pack";
+    return path.size() > ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+/**
+ * @brief Returns true if the pack contains an instance with the given id
+ * 
+ * @param id Instance number
+ * @return Returns true if the instance exists
+ */
+bool InstancePack::contains(int id) const
+{
+    return findEntry(id) != nullptr;
+}
+
+/**
+ * @brief Returns the instance with the given id. On little-endian hosts the
+ * instance is a zero-copy view into the mapped pack, and keeps the pack open.
+ * 
+ * @param id Instance number
+ * @return Returns a shared pointer to the instance. Throws std::out_of_range if it does not exist.
+ */
+InstancePtr InstancePack::getInstance(int id) const
+{
+    const PackEntry* entry = findEntry(id);
+    if (entry == nullptr)
+        throw std::out_of_range(filePath + " does not contain instance " + std::to_string(id));
+
+    const std::string name = filePath + "[" + std::to_string(id) + "]";
+    const char* data = file.data() + entry->offset;
+
+    if (hostIsLittleEndian())
+    {
+        return Instance::createView(reinterpret_cast<const int*>(data), entry->machines, entry->jobs,
+            name, shared_from_this());
+    }
+
+    // Big-endian hosts need a converted copy
+    auto copy = std::make_shared<std::vector<int>>(entry->machines * entry->jobs);
+    for (size_t i = 0; i < copy->size(); i++)
+        (*copy)[i] = static_cast<int32_t>(static_cast<uint32_t>(readLE(data + i * 4, 4)));
+
+    return Instance::createView(copy->data(), entry->machines, entry->jobs, name, copy);
+}
+
+/**
+ * @brief Returns the index of all instances in the pack
+ * 
+ * @return Returns a reference to the vector of index entries
+ */
+const std::vector<PackEntry>& InstancePack::getEntries() const
+{
+    return entries;
+}
+
+/**
+ * @brief Returns the path of the pack file
+ * 
+ * @return Returns the file path
+ */
+const std::string& InstancePack::getFilePath() const
+{
+    return filePath;
+}
+
+/**
+ * @brief Looks up the index entry for the given id
+ * 
+ * @param id Instance number
+ * @return Returns a pointer to the entry, or nullptr if it does not exist
+ */
+const PackEntry* InstancePack::findEntry(int id) const
+{
+    // Packs created from a range are ordered by id, so try a direct lookup first
+    if (!entries.empty())
+    {
+        const long long guess = static_cast<long long>(id) - entries.front().id;
+        if (guess >= 0 && guess < static_cast<long long>(entries.size()) && entries[guess].id == id)
+            return &entries[guess];
+    }
+
+    for (auto& entry : entries)
+    {
+        if (entry.id == id)
+            return &entry;
+    }
+
+    return nullptr;
+}
+
+// ============================================================
+
+/**
+ * @brief Construct a new InstancePackWriter object
+ */
+InstancePackWriter::InstancePackWriter()
+    : curEntry(0), curRow(0), pos(0)
+{
+}
+
+/**
+ * @brief Creates the pack file and writes its header and index. Matrix offsets
+ * are assigned here, so the offset of each given entry is ignored.
+ * 
+ * @param packFile Path of the pack file to create
+ * @param _entries Id, job count and machine count of every instance, in the order they will be written
+ * @return Returns true on success. Otherwise false.
+ */
+bool InstancePackWriter::open(const char* packFile, const std::vector<PackEntry>& _entries)
+{
+    entries = _entries;
+    curEntry = 0;
+    curRow = 0;
+
+    // Assign aligned matrix offsets after the header and index
+    uint64_t offset = alignOffset(PACK_HEADER_SIZE + static_cast<uint64_t>(entries.size()) * PACK_ENTRY_SIZE);
+    for (auto& entry : entries)
+    {
+        if (entry.jobs == 0 || entry.machines == 0 || entry.jobs > UINT32_MAX || entry.machines > UINT32_MAX)
+            return false;
+
+        entry.offset = offset;
+        offset = alignOffset(offset + static_cast<uint64_t>(entry.jobs) * entry.machines * sizeof(int32_t));
+    }
+
+    os.open(packFile, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!os.good()) return false;
+
+    // Header
+    os.write(PACK_MAGIC, sizeof(PACK_MAGIC));
+    writeLE(os, PACK_VERSION, 4);
+    writeLE(os, entries.size(), 4);
+    writeLE(os, PACK_HEADER_SIZE, 8);
+    writeLE(os, 0, 8);
+
+    // Index
+    for (auto& entry : entries)
+    {
+        writeLE(os, static_cast<uint32_t>(entry.id), 4);
+        writeLE(os, entry.jobs, 4);
+        writeLE(os, entry.machines, 4);
+        writeLE(os, 0, 4);
+        writeLE(os, entry.offset, 8);
+        writeLE(os, 0, 8);
+    }
+
+    pos = PACK_HEADER_SIZE + static_cast<uint64_t>(entries.size()) * PACK_ENTRY_SIZE;
+    return os.good();
+}
+
+/**
+ * @brief Writes the next machine row of the current instance. The first row
+ * of each instance is padded to its aligned offset.
+ * 
+ * @param row Processing times of the machine row
+ * @param cols Number of values in the row, which must match the job count of the instance
+ * @return Returns true on success. Otherwise false.
+ */
+bool InstancePackWriter::writeRow(const int* row, size_t cols)
+{
+    if (!os.is_open() || curEntry >= entries.size() || cols != entries[curEntry].jobs)
+        return false;
+
+    const PackEntry& entry = entries[curEntry];
+
+    for (; pos < entry.offset; pos++)
+        os.put(0);
+
+    rowBytes.resize(cols * sizeof(int32_t));
+    for (size_t j = 0; j < cols; j++)
+    {
+        const uint32_t val = static_cast<uint32_t>(row[j]);
+        for (size_t b = 0; b < sizeof(int32_t); b++)
+            rowBytes[j * sizeof(int32_t) + b] = static_cast<char>((val >> (8 * b)) & 0xFF);
+    }
+
+    os.write(rowBytes.data(), rowBytes.size());
+    pos += rowBytes.size();
+
+    if (++curRow == entry.machines)
+    {
+        curEntry++;
+        curRow = 0;
+    }
+
+    return os.good();
+}
+
+/**
+ * @brief Closes the pack file
+ * 
+ * @return Returns true if every row of every instance was written successfully
+ */
+bool InstancePackWriter::close()
+{
+    if (!os.is_open()) return false;
+
+    const bool complete = curEntry == entries.size();
+    os.close();
+    return complete && !os.fail();
+}
+
+// =========================
+// End of instancepack.cpp
+// =========================
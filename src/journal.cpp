@@ -0,0 +1,141 @@
+/**
+ * @file journal.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the Journal class.
+ * @version 0.1
+ * @date 2019-06-01
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <cstdio>
+#include <fstream>
+#include "journal.h"
+
+using namespace util;
+
+/**
+ * @brief Returns true if the file exists, is not empty, and its last
+ * line has no line break
+ * 
+ * @param filePath Path to the file
+ */
+static bool endsMidLine(const char* filePath)
+{
+    FILE* file = std::fopen(filePath, "rb");
+    if (file == nullptr) return false;
+
+    bool midLine = false;
+    if (std::fseek(file, -1, SEEK_END) == 0)
+        midLine = std::fgetc(file) != '\n';
+
+    std::fclose(file);
+    return midLine;
+}
+
+/**
+ * @brief Opens a journal file for writing
+ * 
+ * @param filePath Path to the journal file
+ * @param append If true, entries are added after the existing entries. Otherwise the file is truncated.
+ * @param policy When written entries are forced to disk
+ * @return Returns true if the file was opened. Otherwise false.
+ */
+bool Journal::open(const char* filePath, bool append, FsyncPolicy policy)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    // End a line left unfinished by an interrupted run, so it
+    // does not run into the first new entry
+    const bool midLine = append && endsMidLine(filePath);
+
+    if (!out.open(filePath, policy, append))
+        return false;
+
+    if (midLine)
+        out.raw("\n", 1);
+
+    return out.flush();
+}
+
+/**
+ * @brief Appends one entry to the journal and flushes it
+ * 
+ * @param key Unique key of the entry
+ * @param fields Field values of the entry
+ * @return Returns true if no write has failed so far
+ */
+bool Journal::write(const std::string& key, const std::vector<std::string>& fields)
+{
+    // Build the whole line first, so it reaches the file in one write
+    std::string line = key;
+    for (auto& f : fields)
+    {
+        line += ',';
+        line += f;
+    }
+    line += '\n';
+
+    std::lock_guard<std::mutex> guard(lock);
+    out.raw(line.data(), line.size());
+    return out.flush();
+}
+
+/**
+ * @brief Closes the journal file
+ * 
+ * @return Returns true if all entries were written successfully
+ */
+bool Journal::close()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return out.close();
+}
+
+/**
+ * @brief Reads every complete entry of a journal file
+ * 
+ * @param filePath Path to the journal file
+ * @return Returns the fields of each entry by key. The map is empty if the file does not exist.
+ */
+std::map<std::string, std::vector<std::string>> Journal::load(const char* filePath)
+{
+    std::map<std::string, std::vector<std::string>> entries;
+
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) return entries;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        // The last line has no line break if its write was interrupted
+        if (file.eof()) break;
+
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        if (line.empty()) continue;
+
+        std::vector<std::string> fields;
+        size_t start = 0;
+        size_t comma;
+
+        while ((comma = line.find(',', start)) != std::string::npos)
+        {
+            fields.push_back(line.substr(start, comma - start));
+            start = comma + 1;
+        }
+        fields.push_back(line.substr(start));
+
+        const std::string key = fields.front();
+        fields.erase(fields.begin());
+        entries[key] = std::move(fields);
+    }
+
+    return entries;
+}
+
+// =========================
+// End of journal.cpp
+// =========================
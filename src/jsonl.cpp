@@ -0,0 +1,301 @@
+/**
+ * @file jsonl.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the JsonRecord and JsonlWriter classes.
+ * @version 0.1
+ * @date 2019-06-01
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "jsonl.h"
+
+using namespace util;
+
+/**
+ * @brief Construct a new, empty JsonRecord object
+ */
+JsonRecord::JsonRecord()
+    : text("{"), first(true), depth(1)
+{
+}
+
+/**
+ * @brief Adds a signed integer field to the current object
+ */
+JsonRecord& JsonRecord::field(const char* k, long long val)
+{
+    key(k);
+    text += std::to_string(val);
+    return *this;
+}
+
+/**
+ * @brief Adds an unsigned integer field to the current object
+ */
+JsonRecord& JsonRecord::field(const char* k, unsigned long long val)
+{
+    key(k);
+    text += std::to_string(val);
+    return *this;
+}
+
+/**
+ * @brief Adds an integer field to the current object
+ */
+JsonRecord& JsonRecord::field(const char* k, int val)
+{
+    return field(k, static_cast<long long>(val));
+}
+
+/**
+ * @brief Adds an unsigned integer field to the current object
+ */
+JsonRecord& JsonRecord::field(const char* k, unsigned int val)
+{
+    return field(k, static_cast<unsigned long long>(val));
+}
+
+/**
+ * @brief Adds an integer field to the current object
+ */
+JsonRecord& JsonRecord::field(const char* k, long val)
+{
+    return field(k, static_cast<long long>(val));
+}
+
+/**
+ * @brief Adds an unsigned integer field to the current object
+ */
+JsonRecord& JsonRecord::field(const char* k, unsigned long val)
+{
+    return field(k, static_cast<unsigned long long>(val));
+}
+
+/**
+ * @brief Adds a floating point field to the current object. JSON has no
+ * representation of infinity or NaN, so those are written as null.
+ */
+JsonRecord& JsonRecord::field(const char* k, double val)
+{
+    key(k);
+
+    if (!std::isfinite(val))
+    {
+        text += "null";
+        return *this;
+    }
+
+    char tmp[64];
+    int len = std::snprintf(tmp, sizeof(tmp), "%.9g", val);
+    if (len > 0)
+        text.append(tmp, static_cast<size_t>(len) < sizeof(tmp) ? static_cast<size_t>(len) : sizeof(tmp) - 1);
+
+    return *this;
+}
+
+/**
+ * @brief Adds a boolean field to the current object
+ */
+JsonRecord& JsonRecord::field(const char* k, bool val)
+{
+    key(k);
+    text += val ? "true" : "false";
+    return *this;
+}
+
+/**
+ * @brief Adds a null field to the current object, for a value that is unknown
+ */
+JsonRecord& JsonRecord::field(const char* k, std::nullptr_t)
+{
+    key(k);
+    text += "null";
+    return *this;
+}
+
+/**
+ * @brief Adds a text field to the current object
+ */
+JsonRecord& JsonRecord::field(const char* k, const char* val)
+{
+    key(k);
+    escaped(val, std::strlen(val));
+    return *this;
+}
+
+/**
+ * @brief Adds a text field to the current object
+ */
+JsonRecord& JsonRecord::field(const char* k, const std::string& val)
+{
+    key(k);
+    escaped(val.data(), val.size());
+    return *this;
+}
+
+/**
+ * @brief Adds an array of integers to the current object
+ * 
+ * @param k Field name
+ * @param vals Pointer to the integers
+ * @param count Number of integers
+ */
+JsonRecord& JsonRecord::field(const char* k, const int* vals, size_t count)
+{
+    key(k);
+    text += '[';
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i > 0) text += ',';
+        text += std::to_string(vals[i]);
+    }
+
+    text += ']';
+    return *this;
+}
+
+/**
+ * @brief Opens a nested object. Following fields are added to it until endObject() is called.
+ * 
+ * @param k Field name of the nested object
+ */
+JsonRecord& JsonRecord::beginObject(const char* k)
+{
+    key(k);
+    text += '{';
+    first = true;
+    depth++;
+    return *this;
+}
+
+/**
+ * @brief Closes the innermost nested object
+ */
+JsonRecord& JsonRecord::endObject()
+{
+    if (depth > 1)
+    {
+        text += '}';
+        first = false;
+        depth--;
+    }
+
+    return *this;
+}
+
+/**
+ * @brief Closes all open objects and returns the finished record, without a line break.
+ * No fields may be added afterwards.
+ * 
+ * @return Returns the JSON text
+ */
+const std::string& JsonRecord::str()
+{
+    while (depth > 0)
+    {
+        text += '}';
+        depth--;
+    }
+
+    return text;
+}
+
+/**
+ * @brief Writes a field separator and the quoted field name
+ */
+void JsonRecord::key(const char* k)
+{
+    if (!first) text += ',';
+    first = false;
+
+    text += '"';
+    text += k;
+    text += "\":";
+}
+
+/**
+ * @brief Writes a quoted and escaped text value
+ */
+void JsonRecord::escaped(const char* val, size_t size)
+{
+    text += '"';
+
+    for (size_t i = 0; i < size; i++)
+    {
+        const unsigned char c = static_cast<unsigned char>(val[i]);
+
+        if (c == '"' || c == '\\')
+        {
+            text += '\\';
+            text += static_cast<char>(c);
+        }
+        else if (c == '\n') text += "\\n";
+        else if (c == '\r') text += "\\r";
+        else if (c == '\t') text += "\\t";
+        else if (c < 0x20)
+        {
+            char tmp[8];
+            std::snprintf(tmp, sizeof(tmp), "\\u%04x", c);
+            text += tmp;
+        }
+        else
+        {
+            text += static_cast<char>(c);
+        }
+    }
+
+    text += '"';
+}
+
+// ============================================================
+
+/**
+ * @brief Opens a file for writing, truncating any existing contents
+ * unless the file is opened for appending
+ * 
+ * @param filePath Path to the output file
+ * @param policy When written data is forced to disk
+ * @param append If true, records are added after the existing records
+ * @return Returns true if the file was opened. Otherwise false.
+ */
+bool JsonlWriter::open(const char* filePath, FsyncPolicy policy, bool append)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return out.open(filePath, policy, append);
+}
+
+/**
+ * @brief Finishes a record, appends it to the file as one line and flushes it
+ * 
+ * @param record Record to write
+ * @return Returns true if no write has failed so far
+ */
+bool JsonlWriter::write(JsonRecord& record)
+{
+    const std::string& line = record.str();
+
+    std::lock_guard<std::mutex> guard(lock);
+    out.raw(line.data(), line.size()).raw("\n", 1);
+    return out.flush();
+}
+
+/**
+ * @brief Closes the file
+ * 
+ * @return Returns true if all records were written successfully
+ */
+bool JsonlWriter::close()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return out.close();
+}
+
+// =========================
+// End of jsonl.cpp
+// =========================
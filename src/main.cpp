@@ -15,10 +15,20 @@
 #include <set>
 
 #include "experiment.h"
+#include "instancepack.h"
+#include "timesfile.h"
+#include "instancegen.h"
+#include "setuptimes.h"
+#include "csvwriter.h"
 
 using namespace std;
 
 int runDebugJobSeq(const char* paramsFile, const char* seq);
+int runCreatePack(int argc, char** argv);
+int runDecodeTimes(int argc, char** argv);
+int runGenerate(int argc, char** argv);
+int runGenerateSetups(int argc, char** argv);
+int runScaling(int argc, char** argv);
 
 int main(int argc, char** argv)
 {
@@ -28,12 +38,51 @@ int main(int argc, char** argv)
         cout << "Error: Missing command line parameter." << endl;
         cout << "Proper usage: " << argv[0] << " [param file] \"[Debug Job Sequence]\"" << endl;
         cout << "The debug job sequence is optional, and must be passed in the form \"1 2 3 4 5\" as a single argument, where the values are the jobs separated by spaces." << endl;
+        cout << "To convert data set files into an instance pack: " << argv[0] << " pack [input files dir] [min file] [max file] [pack file]" << endl;
+        cout << "To convert a binary times file into csv matrices or gantt rows: " << argv[0] << " decode [csv|gantt] [times file] [output]" << endl;
+        cout << "To generate synthetic data sets: " << argv[0] << " generate [output] [jobs] [machines] [seed] [count] [distribution] [min time] [max time]" << endl;
+        cout << "To generate setup times for a data set: " << argv[0] << " setups [data set file] [output] [seed] [min time] [max time]" << endl;
+        cout << "To check results against golden results and a timing baseline: " << argv[0] << " verify [param file]" << endl;
+        cout << "Verify exits with " << cs471::VERIFY_QUALITY_FAILED << " on a quality regression and " << cs471::VERIFY_TIME_FAILED << " on a speed regression." << endl;
+        cout << "To measure how a batch scales with the number of threads: " << argv[0] << " scaling [param file] [thread counts] [report prefix] [repetitions]" << endl;
         return EXIT_FAILURE;
     }
 
     try
     {
-        if (argc > 2)
+        if (string(argv[1]) == "pack")
+        {
+            return runCreatePack(argc, argv);
+        }
+        else if (string(argv[1]) == "decode")
+        {
+            return runDecodeTimes(argc, argv);
+        }
+        else if (string(argv[1]) == "generate")
+        {
+            return runGenerate(argc, argv);
+        }
+        else if (string(argv[1]) == "setups")
+        {
+            return runGenerateSetups(argc, argv);
+        }
+        else if (string(argv[1]) == "verify")
+        {
+            if (argc != 3)
+            {
+                cerr << "Proper usage: " << argv[0] << " verify [param file]" << endl;
+                cerr << "Exits with " << cs471::VERIFY_QUALITY_FAILED << " on a quality regression and " << cs471::VERIFY_TIME_FAILED << " on a speed regression." << endl;
+                return 1;
+            }
+
+            cs471::Experiment ex(argv[2]);
+            return ex.runVerify();
+        }
+        else if (string(argv[1]) == "scaling")
+        {
+            return runScaling(argc, argv);
+        }
+        else if (argc > 2)
         {
             return runDebugJobSeq(argv[1], argv[2]);
         }
@@ -91,6 +140,306 @@ int runDebugJobSeq(const char* paramsFile, const char* seq)
     return 0;
 }
 
+/**
+ * @brief Converts a range of [NUM].txt data set files into a single binary instance pack
+ * 
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments: pack [input files dir] [min file] [max file] [pack file]
+ * @return Returns a non-zero error code on failure, otherwise zero.
+ */
+int runCreatePack(int argc, char** argv)
+{
+    if (argc != 6)
+    {
+        cerr << "Proper usage: " << argv[0] << " pack [input files dir] [min file] [max file] [pack file]" << endl;
+        return 1;
+    }
+
+    int minId = atoi(argv[3]);
+    int maxId = atoi(argv[4]);
+
+    cout << "Packing data sets " << minId << " to " << maxId << " from " << argv[2] << " ..." << endl;
+
+    if (!fshop::InstancePack::create(argv[5], argv[2], minId, maxId))
+    {
+        cerr << "Error: Failed to create instance pack." << endl;
+        return 2;
+    }
+
+    cout << "Instance pack written to: " << argv[5] << endl;
+    return 0;
+}
+
+/**
+ * @brief Converts a binary times file back into start and departure time *.csv
+ * files, or into Gantt chart rows for results/gen-gantt.r
+ * 
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments: decode [csv|gantt] [times file] [output]
+ * @return Returns a non-zero error code on failure, otherwise zero.
+ */
+int runDecodeTimes(int argc, char** argv)
+{
+    const string mode = argc > 2 ? argv[2] : "";
+
+    if (argc != 5 || (mode != "csv" && mode != "gantt"))
+    {
+        cerr << "Proper usage: " << argv[0] << " decode csv [times file] [output file prefix]" << endl;
+        cerr << "          or: " << argv[0] << " decode gantt [times file] [output file]" << endl;
+        return 1;
+    }
+
+    fshop::TimesData data = fshop::TimesFile::read(argv[3]);
+
+    bool success;
+    if (mode == "csv")
+        success = fshop::TimesFile::exportCsv(data, argv[4]);
+    else
+        success = fshop::TimesFile::exportGantt(data, argv[4]);
+
+    if (!success)
+    {
+        cerr << "Error: Unable to write output: " << argv[4] << endl;
+        return 2;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Generates synthetic data sets with Taillard's random number generator. Consecutive
+ * data sets continue the random stream of the previous one. Data sets are streamed
+ * to the output one machine row at a time.
+ * 
+ * The output is an instance pack if it ends in .pack, a single text file if count is 1,
+ * or otherwise the input files directory prefix that [NUM].txt files are written to.
+ * 
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments: generate [output] [jobs] [machines] [seed] [count] [distribution] [min time] [max time]
+ * @return Returns a non-zero error code on failure, otherwise zero.
+ */
+int runGenerate(int argc, char** argv)
+{
+    if (argc < 6 || argc > 10)
+    {
+        cerr << "Proper usage: " << argv[0] << " generate [output] [jobs] [machines] [seed] [count] [distribution] [min time] [max time]" << endl;
+        cerr << "The count (1), distribution (uniform, jobcorr or machcorr) and time range (1 99) are optional." << endl;
+        return 1;
+    }
+
+    const string output = argv[2];
+    const long long jobs = atoll(argv[3]);
+    const long long machines = atoll(argv[4]);
+    const long long seed = atoll(argv[5]);
+    const int count = argc > 6 ? atoi(argv[6]) : 1;
+    const int minTime = argc > 8 ? atoi(argv[8]) : 1;
+    const int maxTime = argc > 9 ? atoi(argv[9]) : 99;
+
+    fshop::GenDistribution distribution = fshop::GEN_UNIFORM;
+    if (argc > 7 && !fshop::parseGenDistribution(argv[7], distribution))
+    {
+        cerr << "Error: Unknown distribution: " << argv[7] << endl;
+        return 1;
+    }
+
+    if (jobs <= 0 || machines <= 0 || count <= 0 || seed <= 0 || seed >= 2147483647)
+    {
+        cerr << "Error: jobs, machines and count must be positive, and seed must be in [1, 2147483646]." << endl;
+        return 1;
+    }
+
+    fshop::InstanceGenerator gen(jobs, machines, static_cast<int32_t>(seed), distribution, minTime, maxTime);
+    vector<int> row(jobs);
+
+    if (fshop::InstancePack::isPackFile(output))
+    {
+        vector<fshop::PackEntry> entries;
+        for (int id = 0; id < count; id++)
+            entries.push_back({ id, static_cast<size_t>(jobs), static_cast<size_t>(machines), 0 });
+
+        fshop::InstancePackWriter writer;
+        if (!writer.open(output.c_str(), entries))
+        {
+            cerr << "Error: Unable to create instance pack: " << output << endl;
+            return 2;
+        }
+
+        for (int id = 0; id < count; id++)
+        {
+            for (long long m = 0; m < machines; m++)
+            {
+                gen.nextRow(row.data());
+                writer.writeRow(row.data(), row.size());
+            }
+        }
+
+        if (!writer.close())
+        {
+            cerr << "Error: Unable to write instance pack: " << output << endl;
+            return 2;
+        }
+    }
+    else
+    {
+        for (int id = 0; id < count; id++)
+        {
+            const string file = count == 1 ? output : output + to_string(id) + ".txt";
+
+            util::CsvWriter txt;
+            txt.setDelimiter(' ');
+            if (!txt.open(file.c_str()))
+            {
+                cerr << "Error: Unable to create data set file: " << file << endl;
+                return 2;
+            }
+
+            txt.field(machines).field(jobs).endRow();
+
+            for (long long m = 0; m < machines; m++)
+            {
+                gen.nextRow(row.data());
+                for (long long j = 0; j < jobs; j++)
+                    txt.field(row[j]);
+
+                txt.endRow();
+            }
+
+            if (!txt.close())
+            {
+                cerr << "Error: Unable to write data set file: " << file << endl;
+                return 2;
+            }
+        }
+    }
+
+    cout << "Generated " << count << " data set(s) of " << jobs << " jobs and " << machines << " machines: " << output << endl;
+    return 0;
+}
+
+/**
+ * @brief Generates uniform sequence-dependent setup times for a data set with Taillard's
+ * random number generator. The output is a binary setup times file if it ends in .sdst,
+ * or otherwise a copy of the data set file with the setup time blocks appended.
+ * 
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments: setups [data set file] [output] [seed] [min time] [max time]
+ * @return Returns a non-zero error code on failure, otherwise zero.
+ */
+int runGenerateSetups(int argc, char** argv)
+{
+    if (argc < 5 || argc > 7)
+    {
+        cerr << "Proper usage: " << argv[0] << " setups [data set file] [output] [seed] [min time] [max time]" << endl;
+        cerr << "The time range (1 49) is optional." << endl;
+        return 1;
+    }
+
+    const string output = argv[3];
+    const long long seed = atoll(argv[4]);
+    const int minTime = argc > 5 ? atoi(argv[5]) : 1;
+    const int maxTime = argc > 6 ? atoi(argv[6]) : 49;
+
+    if (seed <= 0 || seed >= 2147483647 || minTime < 0 || maxTime < minTime)
+    {
+        cerr << "Error: seed must be in [1, 2147483646], and the time range must be non-negative." << endl;
+        return 1;
+    }
+
+    fshop::InstancePtr instance = fshop::Instance::loadFromFile(argv[2]);
+    const size_t machines = instance->getTotalMachines();
+    const size_t jobs = instance->getTotalJobs();
+
+    // One block per machine, in the file order
+    fshop::TaillardRandom rand(static_cast<int32_t>(seed));
+    vector<int> blocks(machines * jobs * jobs);
+    for (size_t i = 0; i < blocks.size(); i++)
+        blocks[i] = rand.unif(minTime, maxTime);
+
+    fshop::SetupTimesPtr setups = fshop::SetupTimes::create(blocks, machines, jobs, output);
+
+    bool success;
+    if (fshop::SetupTimes::isBinaryFile(output))
+    {
+        success = setups->writeBinary(output.c_str());
+    }
+    else
+    {
+        util::CsvWriter txt;
+        txt.setDelimiter(' ');
+        success = txt.open(output.c_str());
+
+        if (success)
+        {
+            const int* const* matrix = instance->getProcTimeMatrix();
+            txt.field(static_cast<unsigned long>(machines)).field(static_cast<unsigned long>(jobs)).endRow();
+
+            for (size_t m = 0; m < machines; m++)
+            {
+                for (size_t j = 0; j < jobs; j++)
+                    txt.field(matrix[m][j]);
+
+                txt.endRow();
+            }
+
+            success = setups->writeText(txt);
+            success = txt.close() && success;
+        }
+    }
+
+    if (!success)
+    {
+        cerr << "Error: Unable to write setup times: " << output << endl;
+        return 2;
+    }
+
+    cout << "Generated setup times of " << jobs << " jobs and " << machines << " machines: " << output << endl;
+    return 0;
+}
+
+/**
+ * @brief Reruns the experiment of a parameter file at several thread counts and
+ * writes a report of the wall time, speedup, efficiency and latency of each
+ * 
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments: scaling [param file] [thread counts] [report prefix] [repetitions]
+ * @return Returns a non-zero error code on failure, otherwise zero.
+ */
+int runScaling(int argc, char** argv)
+{
+    if (argc < 5 || argc > 6)
+    {
+        cerr << "Proper usage: " << argv[0] << " scaling [param file] [thread counts] [report prefix] [repetitions]" << endl;
+        cerr << "Thread counts are separated by commas, such as 1,2,4,8. Repetitions (1) are optional." << endl;
+        return 1;
+    }
+
+    vector<int> threadCounts;
+    stringstream ss(argv[3]);
+    string count;
+
+    while (getline(ss, count, ','))
+    {
+        const int threads = atoi(count.c_str());
+        if (threads < 1 || threads > 256)
+        {
+            cerr << "Error: Thread counts must be in [1, 256]: " << count << endl;
+            return 1;
+        }
+
+        threadCounts.push_back(threads);
+    }
+
+    const int repetitions = argc > 5 ? atoi(argv[5]) : 1;
+    if (threadCounts.empty() || repetitions < 1)
+    {
+        cerr << "Error: At least one thread count and repetition is required." << endl;
+        return 1;
+    }
+
+    cs471::Experiment ex(argv[2]);
+    return ex.runScaling(threadCounts, repetitions, argv[4]);
+}
+
 // =========================
 // End of main.cpp
 // =========================
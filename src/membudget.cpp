@@ -0,0 +1,247 @@
+/**
+ * @file membudget.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the MemoryBudget class and the resident memory functions.
+ * @version 0.1
+ * @date 2019-06-05
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <chrono>
+#include <cstdio>
+#include "membudget.h"
+
+#if defined(_WIN32)
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+    #include <unistd.h>
+#endif
+
+using namespace util;
+
+#if defined(_WIN32)
+/**
+ * @brief Reads the memory counters of the process
+ */
+static bool processMemory(PROCESS_MEMORY_COUNTERS& pmc)
+{
+    return K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) != 0;
+}
+#endif
+
+/**
+ * @brief Returns the resident set size of the process, or zero if it is unknown
+ */
+size_t util::currentRssBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    return processMemory(pmc) ? pmc.WorkingSetSize : 0;
+#elif defined(__linux__)
+    // The second field of statm is the resident size in pages
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr) return 0;
+
+    unsigned long long size = 0, resident = 0;
+    const int read = std::fscanf(statm, "%llu %llu", &size, &resident);
+    std::fclose(statm);
+
+    return read == 2 ? static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Returns the largest resident set size the process has had, or zero if it is unknown
+ */
+size_t util::peakRssBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    return processMemory(pmc) ? pmc.PeakWorkingSetSize : 0;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+    #if defined(__APPLE__)
+        return static_cast<size_t>(usage.ru_maxrss);
+    #else
+        // Linux reports kilobytes
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+    #endif
+#endif
+}
+
+/**
+ * @brief Construct a new MemoryBudget object
+ * 
+ * @param _limitBytes Budget in bytes, or zero for no limit
+ */
+MemoryBudget::MemoryBudget(size_t _limitBytes)
+    : limitBytes(_limitBytes), reserved(0), peakReserved(0), delayedCount(0), totalWaitMs(0.0)
+{
+}
+
+/**
+ * @brief Sets the budget. Requests waiting for bytes are checked again.
+ * 
+ * @param _limitBytes Budget in bytes, or zero for no limit
+ */
+void MemoryBudget::setLimit(size_t _limitBytes)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        limitBytes = _limitBytes;
+    }
+
+    freed.notify_all();
+}
+
+/**
+ * @brief Returns the budget in bytes, or zero if there is no limit
+ */
+size_t MemoryBudget::getLimit() const
+{
+    return limitBytes;
+}
+
+/**
+ * @brief Waits until the bytes fit within the budget, then holds them until release().
+ * If a shared reservation is given and not yet held, its bytes are held as well until
+ * releaseShared(). Once it is held, the request runs alone when nothing but the shared
+ * bytes are held, so requests sharing an oversized reservation do not wait on it.
+ * 
+ * @param bytes Estimated bytes of the work being admitted
+ * @param cancelToken Optional cancellation token. Waiting stops once it is cancelled.
+ * @param waitMs Optional out pointer that receives the time spent waiting, in milliseconds
+ * @param shared Optional reservation shared with other requests
+ * @return Returns true if the bytes are now held, or false if the wait was cancelled
+ */
+bool MemoryBudget::acquire(size_t bytes, const CancelToken* cancelToken, double* waitMs, SharedReservation* shared)
+{
+    using namespace std::chrono;
+
+    const steady_clock::time_point start = steady_clock::now();
+    std::unique_lock<std::mutex> guard(lock);
+
+    // Whether the shared bytes are held may change while waiting, so it is checked every time
+    auto needed = [&]() { return bytes + (shared != nullptr && !shared->held ? shared->bytes : 0); };
+    auto ownHeld = [&]() { return shared != nullptr && shared->held ? shared->bytes : 0; };
+    auto fits = [&]() { return limitBytes == 0 || reserved <= ownHeld() || reserved + needed() <= limitBytes; };
+    const bool delayed = !fits();
+
+    // The token is polled, since cancelling it does not signal this budget
+    while (!fits())
+    {
+        if (cancelToken != nullptr && cancelToken->isCancelled())
+            break;
+
+        freed.wait_for(guard, milliseconds(20));
+    }
+
+    const double waited = static_cast<double>(duration_cast<nanoseconds>(steady_clock::now() - start).count()) / 1000000.0;
+    if (waitMs != nullptr) *waitMs = waited;
+
+    if (delayed)
+    {
+        delayedCount++;
+        totalWaitMs += waited;
+    }
+
+    if (!fits())
+        return false;
+
+    reserved += needed();
+    if (shared != nullptr) shared->held = true;
+    if (reserved > peakReserved) peakReserved = reserved;
+    return true;
+}
+
+/**
+ * @brief Returns bytes held by an earlier acquire()
+ * 
+ * @param bytes Bytes to return
+ */
+void MemoryBudget::release(size_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        reserved = bytes < reserved ? reserved - bytes : 0;
+    }
+
+    freed.notify_all();
+}
+
+/**
+ * @brief Returns the bytes of a shared reservation, if they are held
+ * 
+ * @param shared Reservation passed to earlier acquire() calls
+ */
+void MemoryBudget::releaseShared(SharedReservation& shared)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!shared.held) return;
+
+        reserved = shared.bytes < reserved ? reserved - shared.bytes : 0;
+        shared.held = false;
+    }
+
+    freed.notify_all();
+}
+
+/**
+ * @brief Returns the bytes currently held
+ */
+size_t MemoryBudget::getReserved()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return reserved;
+}
+
+/**
+ * @brief Returns the most bytes held at once since the last resetStats()
+ */
+size_t MemoryBudget::getPeakReserved()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return peakReserved;
+}
+
+/**
+ * @brief Returns the number of requests that had to wait since the last resetStats()
+ */
+size_t MemoryBudget::getDelayedCount()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return delayedCount;
+}
+
+/**
+ * @brief Returns the total time requests spent waiting since the last resetStats(), in milliseconds
+ */
+double MemoryBudget::getTotalWaitMs()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return totalWaitMs;
+}
+
+/**
+ * @brief Clears the peak, delay count and wait time
+ */
+void MemoryBudget::resetStats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    peakReserved = reserved;
+    delayedCount = 0;
+    totalWaitMs = 0.0;
+}
+
+// =========================
+// End of membudget.cpp
+// =========================
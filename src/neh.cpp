@@ -9,7 +9,10 @@
  * 
  */
 
+#include <stdexcept>
 #include "neh.h"
+#include "timing.h"
+#include "trace.h"
 
 // Type alias
 using jtList = std::list<fshop::JobTimePair>;
@@ -18,68 +21,152 @@ using jList = std::list<int>;
 /**
  * @brief Construct a new NEH object
  * 
+ * @param seed Seed for breaking ties between equally good insertions. With the same
+ * seed, runs on the same instance produce the same sequence. Zero picks a random seed.
+ * @param _objective Objective that insertions are chosen by
  */
-fshop::NEH::NEH()
-    : rd(), randEngine(rd()), randChance(0, 1)
+fshop::NEH::NEH(unsigned int seed, ObjectiveType _objective)
+    : rd(), randEngine(seed != 0 ? seed : rd()), randChance(0, 1), objective(_objective)
 { }
 
 /**
- * @brief Runs the NEH algorithm on the given flowshop objective function
+ * @brief Runs the NEH algorithm on the given flowshop objective function.
+ * Candidate sequences only have their objective values evaluated, and are drawn
+ * from the calling thread's arena, which is reset in bulk after every insertion step.
+ * A full solution is only created for the final sequence.
  * 
  * @param objectiveFs Pointer to the flowshop objective function being optimized
- * @return Returns a unique_ptr to a FlowshopSolution object that contains the best solution found.
+ * @param cancelToken Optional cancellation token, checked before every insertion step
+ * @return Returns a unique_ptr to a FlowshopSolution object that contains the best solution found,
+ * or nullptr if the run was cancelled.
  */
-fsSol fshop::NEH::run(FlowshopBasic* const objectiveFs)
+fsSol fshop::NEH::run(FlowshopBasic* const objectiveFs, const util::CancelToken* cancelToken)
 {
+    if (objective != OBJ_CMAX && objectiveFs->getDueDates() == nullptr)
+        throw std::invalid_argument(std::string("Error: The ") + objectiveTypeName(objective) + " objective needs due dates");
+
+    util::Arena& arena = util::threadArena();
+    arena.reset();
+
+    util::Tracer& tracer = util::Tracer::global();
+
     jtList availJobsList;
-    makeInitialAvailJobList(objectiveFs, availJobsList);
+    {
+        FSHOP_TIME_PHASE(util::PHASE_SORT);
+        FSHOP_TRACE("sort", "neh");
+        makeInitialAvailJobList(objectiveFs, availJobsList);
+    }
 
     auto firstJob = availJobsList.front();
     availJobsList.pop_front();
 
-    fsSol bestSol = nullptr;
     jList* curJobSeq = new jList();
     jList* nextJobSeq = new jList();
     curJobSeq->push_back(firstJob.job);
 
-    while (availJobsList.size() > 0)
+    // A single job has only one possible sequence
+    ObjectiveValue bestValue = { 0, 0, 0, 0, 0 };
+    if (availJobsList.empty())
+    {
+        int singleSeq = firstJob.job;
+        bestValue = objectiveFs->evaluate(&singleSeq, 1);
+    }
+
+    bool cancelled = false;
     {
-        auto nextJob = availJobsList.front();
-        availJobsList.pop_front();
+        FSHOP_TIME_PHASE(util::PHASE_INSERTION);
 
-        bestSol.reset();
-        bestSol = bestPermutation(objectiveFs, *curJobSeq, nextJob.job, *nextJobSeq);
+        while (availJobsList.size() > 0)
+        {
+            // Stop early if the batch was cancelled
+            if (cancelToken != nullptr && cancelToken->isCancelled())
+            {
+                cancelled = true;
+                break;
+            }
+
+            auto nextJob = availJobsList.front();
+            availJobsList.pop_front();
+
+            // Trace sampled insertion steps, each is one batch of candidate evaluations
+            const size_t step = curJobSeq->size();
+            const bool traceStep = tracer.sampleStep(step);
+            const int64_t stepBegin = traceStep ? tracer.now() : 0;
+
+            // Release the previous step's sequences in bulk
+            arena.reset();
+            bestValue = bestPermutation(objectiveFs, arena, *curJobSeq, nextJob.job, *nextJobSeq);
+
+            if (traceStep)
+            {
+                const int64_t candidates = static_cast<int64_t>(step + 1);
+                tracer.record({ "insert", "neh", stepBegin, tracer.now() - stepBegin, { "step", "candidates" }, { static_cast<int64_t>(step), candidates } });
+            }
+
+            auto tmp = curJobSeq;
+            curJobSeq = nextJobSeq;
+            nextJobSeq = tmp;
+        }
+    }
 
-        auto tmp = curJobSeq;
-        curJobSeq = nextJobSeq;
-        nextJobSeq = tmp;
+    // Create the solution of the final sequence, without evaluating it again
+    fsSol retSol = nullptr;
+    if (!cancelled)
+    {
+        std::vector<int> bestSeq(curJobSeq->begin(), curJobSeq->end());
+        retSol = objectiveFs->makeSolution(bestSeq.data(), bestSeq.size(), bestValue);
     }
 
     delete curJobSeq;
     delete nextJobSeq;
+    arena.reset();
 
-    return std::move(bestSol);
+    return std::move(retSol);
 }
 
 /**
- * @brief Generates the initial jobs list and sorts them by processing time in descending order
+ * @brief Estimates the memory a single NEH run holds at its peak: the job lists,
+ * the candidate arrays of one insertion step, the flowshop's column buffers and
+ * the final solution's sequence. The instance itself is not included.
+ * 
+ * @param machines Number of machines of the instance
+ * @param jobs Number of jobs of the instance
+ * @return Returns the estimate in bytes
+ */
+size_t fshop::NEH::estimateBytes(size_t machines, size_t jobs)
+{
+    // A list node holds its value and two links, plus the allocator's header
+    const size_t listNodeBytes = sizeof(JobTimePair) + 2 * sizeof(void*) + 16;
+
+    // Available jobs, current and next sequence
+    size_t bytes = 3 * jobs * listNodeBytes;
+
+    // Candidate and best arrays of one step, and the final sequence and its solution copy
+    bytes += 4 * jobs * sizeof(int);
+
+    // Column buffers of the flowshop and its shared clone
+    bytes += 4 * machines * sizeof(int);
+
+    // Fixed overhead of the flowshop, solution and arena block headers
+    return bytes + 4096;
+}
+
+/**
+ * @brief Generates the initial jobs list and sorts them by processing time in descending order.
+ * Total processing times are taken from the totals precomputed by the shared instance.
  * 
  * @param objectiveFs Pointer to the flowshop objective function being optimized
  * @param outList Out reference to the job list that will be filled and sorted
  */
 void fshop::NEH::makeInitialAvailJobList(FlowshopBasic* const objectiveFs, jtList& outList)
 {
-    const size_t numMachines = objectiveFs->getTotalMachines();
     const size_t numJobs = objectiveFs->getTotalJobs();
+    const int* jobTotals = objectiveFs->getInstance()->getJobTotals();
     
     for (size_t j = 1; j <= numJobs; j++)
     {
-        int sum = 0;
-        for (size_t m = 1; m <= numMachines; m++)
-            sum += objectiveFs->getProcessingTime(m, j);
-        
         outList.emplace_back(
-            JobTimePair(j, sum)
+            JobTimePair(j, jobTotals[j - 1])
         );
     }
 
@@ -89,49 +176,69 @@ void fshop::NEH::makeInitialAvailJobList(FlowshopBasic* const objectiveFs, jtLis
 
 /**
  * @brief Finds the best permutation of an existing job sequence and an additional inserted job.
+ * Candidates are built in one of two arena arrays, and the arrays are swapped whenever a
+ * candidate improves on the best sequence so far.
  * 
  * @param objectiveFs Pointer to the flowshop objective function being optimized
+ * @param arena Arena that candidate sequences are allocated from
  * @param baseList Base job sequence list
  * @param jobInsert Job that is being inserted
  * @param outBestSeq Out reference list that will be filled with the best job sequence found
- * @return Returns a unique_ptr to the FlowshopSolution object created from the best job sequence
+ * @return Returns the objective values of the best job sequence
  */
-fsSol fshop::NEH::bestPermutation(FlowshopBasic* const objectiveFs, const jList& baseList, int jobInsert, jList& outBestSeq)
+fshop::ObjectiveValue fshop::NEH::bestPermutation(FlowshopBasic* const objectiveFs, util::Arena& arena, const jList& baseList, int jobInsert, jList& outBestSeq)
 {
-    fsSol bestSol = nullptr;
+    ObjectiveValue bestValue = { 0, 0, 0, 0, 0 };
+    long long bestScore = 0;
+    bool haveBest = false;
     outBestSeq.clear();
 
-    jList bufferList;
-    int* seqArr = new int[baseList.size() + 1];
+    const size_t seqSize = baseList.size() + 1;
+    int* seqArr = arena.allocArray<int>(seqSize);
+    int* bestArr = arena.allocArray<int>(seqSize);
+    if (seqArr == nullptr || bestArr == nullptr)
+        throw std::bad_alloc();
 
-    for (size_t i = 0; i <= baseList.size(); i++)
+    for (size_t i = 0; i < seqSize; i++)
     {
-        bufferList = jList(baseList.begin(), baseList.end());
-        auto it = bufferList.begin();
-        std::advance(it, i);
-
-        bufferList.insert(it, jobInsert);
-        
-        size_t index = 0;
+        // Build the candidate sequence with the inserted job at position i
+        auto it = baseList.begin();
+        for (size_t index = 0; index < seqSize; index++)
+        {
+            if (index == i)
+            {
+                seqArr[index] = jobInsert;
+            }
+            else
+            {
+                seqArr[index] = *it;
+                it++;
+            }
+        }
 
-        for (auto i = bufferList.begin(); i != bufferList.end(); i++)
+        ObjectiveValue value;
         {
-            seqArr[index] = *i;
-            index++;
+            FSHOP_TIME_PHASE(util::PHASE_EVALUATION);
+            value = objectiveFs->evaluate(seqArr, seqSize);
         }
 
-        auto result = objectiveFs->calcObjective(seqArr, bufferList.size());
-        if (bestSol == nullptr || result->cmax < bestSol->cmax ||
-            (result->cmax == bestSol->cmax && randChance(randEngine) >= 0.5))
+        const long long score = value.get(objective);
+        if (!haveBest || score < bestScore ||
+            (score == bestScore && randChance(randEngine) >= 0.5))
         {
-            bestSol.reset();
-            bestSol = std::move(result);
-            outBestSeq = jList(bufferList.begin(), bufferList.end());
+            bestValue = value;
+            bestScore = score;
+            haveBest = true;
+
+            int* tmp = bestArr;
+            bestArr = seqArr;
+            seqArr = tmp;
         }
     }
 
-    delete[] seqArr;
-    return std::move(bestSol);
+    outBestSeq.assign(bestArr, bestArr + seqSize);
+
+    return bestValue;
 }
 
 // =========================
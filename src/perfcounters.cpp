@@ -0,0 +1,231 @@
+/**
+ * @file perfcounters.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the PerfCounters class.
+ * @version 0.1
+ * @date 2019-06-02
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <cerrno>
+#include <cstring>
+#include "perfcounters.h"
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+using namespace util;
+
+#if defined(__linux__)
+/**
+ * @brief Sets the perf_event_open type and config of an event
+ */
+static void eventConfig(PerfEvent e, perf_event_attr& attr)
+{
+    uint32_t type = PERF_TYPE_HARDWARE;
+    uint64_t config;
+
+    switch (e)
+    {
+        case PERF_CYCLES:
+            config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_INSTRUCTIONS:
+            config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_L1D_MISSES:
+            type = PERF_TYPE_HW_CACHE;
+            config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PERF_LLC_MISSES:
+            config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        default:
+            config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+    }
+
+    attr.type = type;
+    attr.config = config;
+}
+#endif
+
+/**
+ * @brief Construct a new PerfCounters object, with no counters open
+ */
+PerfCounters::PerfCounters()
+{
+    for (int i = 0; i < PERF_EVENT_COUNT; i++)
+        fds[i] = -1;
+}
+
+/**
+ * @brief Destroys the PerfCounters object, closing its counters
+ */
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+
+/**
+ * @brief Opens a disabled counter for every event, counting the calling thread.
+ * Counters that cannot be opened are left unavailable.
+ * 
+ * @return Returns true if at least one counter was opened. Otherwise false.
+ */
+bool PerfCounters::open()
+{
+    close();
+
+#if defined(__linux__)
+    for (int i = 0; i < PERF_EVENT_COUNT; i++)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        eventConfig(static_cast<PerfEvent>(i), attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        fds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fds[i] < 0 && error.empty())
+            error = std::string(eventName(static_cast<PerfEvent>(i))) + ": " + std::strerror(errno);
+    }
+#else
+    error = "perf_event_open is only available on Linux";
+#endif
+
+    return isAvailable();
+}
+
+/**
+ * @brief Closes every open counter
+ */
+void PerfCounters::close()
+{
+    for (int i = 0; i < PERF_EVENT_COUNT; i++)
+    {
+#if defined(__linux__)
+        if (fds[i] >= 0)
+            ::close(fds[i]);
+#endif
+        fds[i] = -1;
+    }
+
+    error.clear();
+}
+
+/**
+ * @brief Returns true if at least one counter is open
+ */
+bool PerfCounters::isAvailable() const
+{
+    for (int i = 0; i < PERF_EVENT_COUNT; i++)
+    {
+        if (fds[i] >= 0) return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Returns why the first unavailable counter could not be opened,
+ * or an empty string if every counter is open
+ */
+const std::string& PerfCounters::getError() const
+{
+    return error;
+}
+
+/**
+ * @brief Resets every open counter to zero and starts counting
+ */
+void PerfCounters::start()
+{
+#if defined(__linux__)
+    for (int i = 0; i < PERF_EVENT_COUNT; i++)
+    {
+        if (fds[i] < 0) continue;
+
+        ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/**
+ * @brief Stops counting and returns the counts since start()
+ * 
+ * @return Returns the event counts
+ */
+PerfSample PerfCounters::stop()
+{
+    PerfSample sample;
+
+#if defined(__linux__)
+    for (int i = 0; i < PERF_EVENT_COUNT; i++)
+    {
+        if (fds[i] >= 0)
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    for (int i = 0; i < PERF_EVENT_COUNT; i++)
+    {
+        if (fds[i] < 0) continue;
+
+        // Value, time enabled, time running
+        uint64_t data[3] = { };
+        if (read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+            continue;
+
+        // Scale up counts of counters that were multiplexed with others
+        double value = static_cast<double>(data[0]);
+        if (data[2] < data[1])
+            value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+
+        sample.values[i] = static_cast<uint64_t>(value);
+        sample.valid[i] = true;
+    }
+#endif
+
+    return sample;
+}
+
+/**
+ * @brief Returns the short name of an event, used as its field name in output files
+ */
+const char* PerfCounters::eventName(PerfEvent e)
+{
+    static const char* names[PERF_EVENT_COUNT] = { "cycles", "instructions", "l1dMisses", "llcMisses", "branchMisses" };
+    return e < PERF_EVENT_COUNT ? names[e] : "unknown";
+}
+
+/**
+ * @brief Returns the performance counters of the calling thread,
+ * opening them the first time they are requested
+ */
+PerfCounters& util::threadPerfCounters()
+{
+    static thread_local PerfCounters counters;
+    static thread_local bool opened = false;
+
+    if (!opened)
+    {
+        counters.open();
+        opened = true;
+    }
+
+    return counters;
+}
+
+// =========================
+// End of perfcounters.cpp
+// =========================
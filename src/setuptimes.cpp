@@ -0,0 +1,340 @@
+/**
+ * @file setuptimes.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the SetupTimes class.
+ * @version 0.1
+ * @date 2019-06-06
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "setuptimes.h"
+#include "fileview.h"
+#include "mem.h"
+
+#define SDST_MAGIC       "FSHSDST"
+#define SDST_VERSION     1
+#define SDST_HEADER_SIZE 32
+#define SDST_DATA_OFFSET 64
+
+using namespace fshop;
+
+/**
+ * @brief Returns true if the host stores integers in little-endian byte order
+ */
+static bool hostIsLittleEndian()
+{
+    const uint16_t val = 1;
+    unsigned char firstByte = 0;
+    std::memcpy(&firstByte, &val, 1);
+    return firstByte == 1;
+}
+
+/**
+ * @brief Decodes a little-endian unsigned integer of the given byte width
+ */
+static uint64_t readLE(const char* p, size_t bytes)
+{
+    uint64_t val = 0;
+    for (size_t i = 0; i < bytes; i++)
+        val |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+
+    return val;
+}
+
+/**
+ * @brief Encodes an unsigned integer of the given byte width in little-endian order
+ */
+static void writeLE(char* p, uint64_t val, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++)
+        p[i] = static_cast<char>((val >> (8 * i)) & 0xFF);
+}
+
+/**
+ * @brief Constructs an empty SetupTimes object
+ * 
+ * @param _machines Number of machines
+ * @param _jobs Number of jobs
+ * @param _filePath Path of the file the setup times are loaded from
+ */
+SetupTimes::SetupTimes(size_t _machines, size_t _jobs, const std::string& _filePath)
+    : times(nullptr), storage(nullptr), machines(_machines), jobs(_jobs), filePath(_filePath)
+{
+}
+
+/**
+ * @brief Loads setup times from a binary *.sdst file, or from the setup blocks
+ * following the processing times of a text data set file
+ * 
+ * @param filePath Path to the file
+ * @return Returns a shared pointer to the setup times. Throws std::runtime_error on error.
+ */
+SetupTimesPtr SetupTimes::loadFromFile(const char* filePath)
+{
+    auto file = std::make_shared<util::FileView>();
+    if (!file->open(filePath))
+        throw std::runtime_error(std::string("Error opening setup times file: ") + filePath);
+
+    const char* data = file->data();
+    const size_t size = file->size();
+
+    if (size >= sizeof(SDST_MAGIC) && std::memcmp(data, SDST_MAGIC, sizeof(SDST_MAGIC)) == 0)
+        return loadBinary(filePath, file, data, size);
+    else
+        return loadText(filePath, data, data + size);
+}
+
+/**
+ * @brief Parses the setup blocks of a text data set file
+ * 
+ * @param filePath Path to the file, used in error messages
+ * @param p Start of the file contents
+ * @param end End of the file contents
+ * @return Returns a shared pointer to the setup times. Throws std::runtime_error on error.
+ */
+SetupTimesPtr SetupTimes::loadText(const char* filePath, const char* p, const char* end)
+{
+    size_t rows = 0;
+    size_t cols = 0;
+
+    if (!util::scanInteger<size_t>(p, end, rows) || !util::scanInteger<size_t>(p, end, cols) || rows == 0 || cols == 0)
+        throw std::runtime_error(std::string("Error: Setup times file has no matrix size: ") + filePath);
+
+    // Skip the header and the processing times
+    p = util::skipLine(p, end);
+    for (size_t r = 0; r < rows; r++)
+        p = util::skipLine(p, end);
+
+    // Every setup time but the last takes at least a digit and a separator,
+    // which bounds the matrix size before it is allocated
+    if ((static_cast<size_t>(end - p) + 1) / 2 / rows / cols < cols)
+        throw std::runtime_error(std::string("Error: Setup times are missing or invalid: ") + filePath);
+
+    std::shared_ptr<SetupTimes> setups(new SetupTimes(rows, cols, filePath));
+    setups->owned.assign(rows * cols * cols, 0);
+
+    for (size_t m = 0; m < rows; m++)
+    {
+        for (size_t pred = 0; pred < cols; pred++)
+        {
+            // Blank lines may separate the blocks. A blank last line ends at end,
+            // which must not be read.
+            const char* next = util::skipBlanks(p, end);
+            while (next < end && *next == '\n')
+            {
+                p = util::skipLine(p, end);
+                next = util::skipBlanks(p, end);
+            }
+
+            for (size_t succ = 0; succ < cols; succ++)
+            {
+                int val = 0;
+                if (!util::scanInteger<int>(p, end, val) || val < 0)
+                    throw std::runtime_error(std::string("Error: Setup times are missing or invalid: ") + filePath);
+
+                setups->owned[(pred * cols + succ) * rows + m] = val;
+            }
+
+            p = util::skipLine(p, end);
+        }
+    }
+
+    setups->times = setups->owned.data();
+    return setups;
+}
+
+/**
+ * @brief Validates a mapped binary setup times file and views its data
+ * 
+ * @param filePath Path to the file, used in error messages
+ * @param file Object owning the mapped file, kept alive by the setup times
+ * @param data Start of the file contents
+ * @param size Size of the file contents in bytes
+ * @return Returns a shared pointer to the setup times. Throws std::runtime_error on error.
+ */
+SetupTimesPtr SetupTimes::loadBinary(const char* filePath, std::shared_ptr<const void> file, const char* data, size_t size)
+{
+    if (size < SDST_HEADER_SIZE || readLE(data + 8, 4) != SDST_VERSION)
+        throw std::runtime_error(std::string("Error: Unsupported setup times file version: ") + filePath);
+
+    const uint64_t rows = readLE(data + 12, 4);
+    const uint64_t cols = readLE(data + 16, 4);
+    const uint64_t offset = readLE(data + 24, 8);
+
+    if (rows == 0 || cols == 0 || offset % sizeof(int32_t) != 0 || offset > size)
+        throw std::runtime_error(std::string("Error: Setup times file is truncated: ") + filePath);
+
+    // Bound the dimensions by the values in the file before multiplying them,
+    // rows * cols * cols of two 32 bit sizes can overflow
+    const uint64_t available = (size - offset) / sizeof(int32_t);
+    if (available / rows / cols < cols)
+        throw std::runtime_error(std::string("Error: Setup times file is truncated: ") + filePath);
+
+    const size_t count = static_cast<size_t>(rows * cols * cols);
+    std::shared_ptr<SetupTimes> setups(new SetupTimes(static_cast<size_t>(rows), static_cast<size_t>(cols), filePath));
+
+    if (hostIsLittleEndian())
+    {
+        setups->storage = file;
+        setups->times = reinterpret_cast<const int*>(data + offset);
+    }
+    else
+    {
+        // Big-endian hosts need a converted copy
+        setups->owned.resize(count);
+        for (size_t i = 0; i < count; i++)
+            setups->owned[i] = static_cast<int32_t>(static_cast<uint32_t>(readLE(data + offset + i * 4, 4)));
+
+        setups->times = setups->owned.data();
+    }
+
+    // Setup times are durations, as in text files
+    for (size_t i = 0; i < count; i++)
+    {
+        if (setups->times[i] < 0)
+            throw std::runtime_error(std::string("Error: Setup times are missing or invalid: ") + filePath);
+    }
+
+    return setups;
+}
+
+/**
+ * @brief Creates setup times from data in the file order, one n x n block per machine
+ * 
+ * @param machineBlocks Setup times indexed [machine][pred][succ]
+ * @param machines Number of machines
+ * @param jobs Number of jobs
+ * @param name Name describing where the setup times came from
+ * @return Returns a shared pointer to the new setup times
+ */
+SetupTimesPtr SetupTimes::create(const std::vector<int>& machineBlocks, size_t machines, size_t jobs, const std::string& name)
+{
+    if (machines == 0 || jobs == 0 || machineBlocks.size() != machines * jobs * jobs)
+        throw std::invalid_argument("Error: Setup times must hold machines * jobs * jobs values");
+
+    std::shared_ptr<SetupTimes> setups(new SetupTimes(machines, jobs, name));
+    setups->owned.resize(machineBlocks.size());
+
+    for (size_t m = 0; m < machines; m++)
+    {
+        for (size_t i = 0; i < jobs * jobs; i++)
+            setups->owned[i * machines + m] = machineBlocks[m * jobs * jobs + i];
+    }
+
+    setups->times = setups->owned.data();
+    return setups;
+}
+
+/**
+ * @brief Returns true if the given path names a binary setup times file,
+ * which is recognised by its .sdst extension
+ * 
+ * @param path File path
+ * @return Returns true if the path ends with ".sdst"
+ */
+bool SetupTimes::isBinaryFile(const std::string& path)
+{
+    const std::string ext = ".sdst";
+    return path.size() > ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0;
+}
+
+/**
+ * @brief Estimates the memory held by loaded setup times
+ * 
+ * @param machines Number of machines
+ * @param jobs Number of jobs
+ * @return Returns the estimate in bytes
+ */
+size_t SetupTimes::estimateBytes(size_t machines, size_t jobs)
+{
+    return machines * jobs * jobs * sizeof(int) + sizeof(SetupTimes);
+}
+
+/**
+ * @brief Returns the number of machines
+ */
+size_t SetupTimes::getTotalMachines() const
+{
+    return machines;
+}
+
+/**
+ * @brief Returns the number of jobs
+ */
+size_t SetupTimes::getTotalJobs() const
+{
+    return jobs;
+}
+
+/**
+ * @brief Returns the path of the file the setup times were loaded from
+ */
+const std::string& SetupTimes::getFilePath() const
+{
+    return filePath;
+}
+
+/**
+ * @brief Writes the setup times to a binary *.sdst file
+ * 
+ * @param filePath Path of the file to create
+ * @return Returns true on success. Otherwise false.
+ */
+bool SetupTimes::writeBinary(const char* filePath) const
+{
+    util::CsvWriter out;
+    if (!out.open(filePath)) return false;
+
+    char header[SDST_DATA_OFFSET] = { 0 };
+    std::memcpy(header, SDST_MAGIC, sizeof(SDST_MAGIC));
+    writeLE(header + 8, SDST_VERSION, 4);
+    writeLE(header + 12, machines, 4);
+    writeLE(header + 16, jobs, 4);
+    writeLE(header + 24, SDST_DATA_OFFSET, 8);
+    out.raw(header, sizeof(header));
+
+    // One predecessor at a time
+    std::vector<char> bytes(jobs * machines * 4);
+    for (size_t pred = 0; pred < jobs; pred++)
+    {
+        const int* block = times + pred * jobs * machines;
+        for (size_t i = 0; i < jobs * machines; i++)
+            writeLE(&bytes[i * 4], static_cast<uint32_t>(block[i]), 4);
+
+        out.raw(bytes.data(), bytes.size());
+    }
+
+    return out.close();
+}
+
+/**
+ * @brief Writes the setup times as the text blocks that follow the
+ * processing times in a data set file, one n x n block per machine
+ * 
+ * @param txt Open writer, with a space delimiter
+ * @return Returns true if every row was written. Otherwise false.
+ */
+bool SetupTimes::writeText(util::CsvWriter& txt) const
+{
+    for (size_t m = 0; m < machines; m++)
+    {
+        for (size_t pred = 0; pred < jobs; pred++)
+        {
+            for (size_t succ = 0; succ < jobs; succ++)
+                txt.field(getSetupTimes(pred, succ)[m]);
+
+            txt.endRow();
+        }
+    }
+
+    return txt.good();
+}
+
+// =========================
+// End of setuptimes.cpp
+// =========================
@@ -0,0 +1,403 @@
+/**
+ * @file timesfile.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the TimesFile class.
+ * @version 0.1
+ * @date 2019-05-30
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "timesfile.h"
+#include "fileview.h"
+
+#ifdef FSHOP_HAVE_ZLIB
+    #include <zlib.h>
+#endif
+
+using namespace fshop;
+
+static const char TIMES_MAGIC[8] = { 'F', 'S', 'T', 'I', 'M', 'E', 'S', '\0' };
+static const uint32_t TIMES_VERSION = 1;
+static const size_t TIMES_HEADER_SIZE = 32;
+static const uint32_t TIMES_FLAG_ZLIB = 1;
+
+// Largest encoded size of a single 32 bit value
+static const size_t VARINT_MAX_BYTES = 5;
+
+/**
+ * @brief Reads an unsigned integer of the given byte width stored in little-endian order
+ */
+static uint64_t readLE(const char* p, size_t bytes)
+{
+    uint64_t val = 0;
+    for (size_t i = 0; i < bytes; i++)
+        val |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+
+    return val;
+}
+
+/**
+ * @brief Appends an unsigned integer of the given byte width to a string in little-endian order
+ */
+static void writeLE(std::string& out, uint64_t val, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++)
+        out.push_back(static_cast<char>((val >> (8 * i)) & 0xFF));
+}
+
+/**
+ * @brief Appends a signed value as a zigzag encoded varint
+ */
+static void putVarint(std::string& out, int64_t val)
+{
+    uint64_t z = (static_cast<uint64_t>(val) << 1) ^ static_cast<uint64_t>(val >> 63);
+
+    while (z >= 0x80)
+    {
+        out.push_back(static_cast<char>((z & 0x7F) | 0x80));
+        z >>= 7;
+    }
+
+    out.push_back(static_cast<char>(z));
+}
+
+/**
+ * @brief Reads a zigzag encoded varint and advances p past it.
+ * Throws std::runtime_error if the value is truncated or out of range.
+ */
+static int getVarint(const char*& p, const char* end)
+{
+    uint64_t z = 0;
+    unsigned shift = 0;
+
+    while (true)
+    {
+        if (p >= end || shift > 7 * (VARINT_MAX_BYTES + 1))
+            throw std::runtime_error("Error: Times file data is truncated or corrupt.");
+
+        const unsigned char b = static_cast<unsigned char>(*p++);
+        z |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) break;
+        shift += 7;
+    }
+
+    const int64_t val = static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+    if (val < INT32_MIN || val > INT32_MAX)
+        throw std::runtime_error("Error: Times file data is truncated or corrupt.");
+
+    return static_cast<int>(val);
+}
+
+/**
+ * @brief Converts a times format name from a parameter file into a TimesFormat.
+ * Accepted names are "csv" and "bin".
+ * 
+ * @param name Name of the format
+ * @return Returns the matching format, or TIMES_CSV if the name is unknown
+ */
+TimesFormat fshop::parseTimesFormat(const std::string& name)
+{
+    if (name == "bin")
+        return TIMES_BIN;
+    else
+        return TIMES_CSV;
+}
+
+/**
+ * @brief Returns true if this build can compress and decompress times files
+ */
+bool TimesFile::compressionAvailable()
+{
+#ifdef FSHOP_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Writes a start and departure time matrix pair to a binary times file
+ * 
+ * @param filePath Path to the output file
+ * @param jobSeq Job sequence the matrices were calculated for
+ * @param startTimes Start time matrix, [machine][sequence position]
+ * @param departTimes Departure time matrix, [machine][sequence position]
+ * @param machines Number of rows in each matrix
+ * @param jobs Number of columns in each matrix and jobs in the sequence
+ * @param compress If true and zlib is available, the encoded block is compressed
+ * @param policy When written data is forced to disk
+ * @return Returns true on success. Otherwise false.
+ */
+bool TimesFile::write(const char* filePath, const int* jobSeq, const int* const* startTimes, const int* const* departTimes,
+                      size_t machines, size_t jobs, bool compress, util::FsyncPolicy policy)
+{
+    if (jobSeq == nullptr || startTimes == nullptr || departTimes == nullptr) return false;
+    if (machines > UINT32_MAX || jobs > UINT32_MAX) return false;
+
+    std::string block;
+    encode(block, jobSeq, startTimes, departTimes, machines, jobs);
+
+    uint32_t flags = 0;
+    std::string packed;
+
+#ifdef FSHOP_HAVE_ZLIB
+    if (compress)
+    {
+        uLongf packedSize = compressBound(static_cast<uLong>(block.size()));
+        packed.resize(packedSize);
+
+        if (compress2(reinterpret_cast<Bytef*>(&packed[0]), &packedSize,
+                      reinterpret_cast<const Bytef*>(block.data()), static_cast<uLong>(block.size()), Z_DEFAULT_COMPRESSION) != Z_OK)
+        {
+            return false;
+        }
+
+        packed.resize(packedSize);
+        flags |= TIMES_FLAG_ZLIB;
+    }
+#else
+    (void)compress;
+#endif
+
+    // Build header
+    std::string header(TIMES_MAGIC, sizeof(TIMES_MAGIC));
+    writeLE(header, TIMES_VERSION, 4);
+    writeLE(header, flags, 4);
+    writeLE(header, machines, 4);
+    writeLE(header, jobs, 4);
+    writeLE(header, block.size(), 8);
+
+    const std::string& body = (flags & TIMES_FLAG_ZLIB) ? packed : block;
+
+    util::CsvWriter out(TIMES_HEADER_SIZE + body.size());
+    if (!out.open(filePath, policy)) return false;
+
+    out.raw(header.data(), header.size()).raw(body.data(), body.size());
+    return out.close();
+}
+
+/**
+ * @brief Reads a binary times file. Throws std::runtime_error on error.
+ * 
+ * @param filePath Path to the times file
+ * @return Returns the decoded job sequence and time matrices
+ */
+TimesData TimesFile::read(const char* filePath)
+{
+    util::FileView view;
+    if (!view.open(filePath))
+        throw std::runtime_error(std::string("Error: Unable to open times file: ") + filePath);
+
+    const char* data = view.data();
+    const size_t size = view.size();
+
+    if (size < TIMES_HEADER_SIZE || std::memcmp(data, TIMES_MAGIC, sizeof(TIMES_MAGIC)) != 0)
+        throw std::runtime_error(std::string("Error: Not a valid times file: ") + filePath);
+    else if (readLE(data + 8, 4) != TIMES_VERSION)
+        throw std::runtime_error(std::string("Error: Unsupported times file version: ") + filePath);
+
+    const uint32_t flags = static_cast<uint32_t>(readLE(data + 12, 4));
+    const uint64_t blockSize = readLE(data + 24, 8);
+
+    TimesData result;
+    result.machines = static_cast<size_t>(readLE(data + 16, 4));
+    result.jobs = static_cast<size_t>(readLE(data + 20, 4));
+
+    if (result.machines == 0 || result.jobs == 0)
+        throw std::runtime_error(std::string("Error: Times file header is invalid: ") + filePath);
+
+    // Every value takes at least one byte, and at most VARINT_MAX_BYTES
+    const uint64_t values = static_cast<uint64_t>(result.jobs) * (2 * static_cast<uint64_t>(result.machines) + 1);
+    if (blockSize < values || blockSize / VARINT_MAX_BYTES > values)
+        throw std::runtime_error(std::string("Error: Times file header is invalid: ") + filePath);
+
+    const char* body = data + TIMES_HEADER_SIZE;
+    const size_t bodySize = size - TIMES_HEADER_SIZE;
+
+    if (flags & TIMES_FLAG_ZLIB)
+    {
+#ifdef FSHOP_HAVE_ZLIB
+        std::string block(static_cast<size_t>(blockSize), '\0');
+        uLongf blockLen = static_cast<uLongf>(blockSize);
+
+        if (uncompress(reinterpret_cast<Bytef*>(&block[0]), &blockLen,
+                       reinterpret_cast<const Bytef*>(body), static_cast<uLong>(bodySize)) != Z_OK || blockLen != blockSize)
+        {
+            throw std::runtime_error(std::string("Error: Unable to decompress times file: ") + filePath);
+        }
+
+        decode(block.data(), block.data() + block.size(), result);
+#else
+        throw std::runtime_error(std::string("Error: Times file is compressed, but zlib support is not available: ") + filePath);
+#endif
+    }
+    else
+    {
+        if (bodySize != blockSize)
+            throw std::runtime_error(std::string("Error: Times file is truncated: ") + filePath);
+
+        decode(body, body + bodySize, result);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Writes decoded time matrices to [prefix]starttimes.csv and
+ * [prefix]departtimes.csv, the same files written for timesFormat=csv
+ * 
+ * @param data Decoded times file
+ * @param fileNamePrefix Prefix of the two output files
+ * @return Returns true on success. Otherwise false.
+ */
+bool TimesFile::exportCsv(const TimesData& data, const std::string& fileNamePrefix)
+{
+    util::CsvWriter startCsv;
+    if (!startCsv.open((fileNamePrefix + "starttimes.csv").c_str())) return false;
+
+    util::CsvWriter departCsv;
+    if (!departCsv.open((fileNamePrefix + "departtimes.csv").c_str())) return false;
+
+    for (size_t m = 0; m < data.machines; m++)
+    {
+        for (size_t j = 0; j < data.jobs; j++)
+        {
+            startCsv.field(data.getStart(m, j));
+            departCsv.field(data.getDepart(m, j));
+        }
+
+        startCsv.endRow();
+        departCsv.endRow();
+    }
+
+    bool startOk = startCsv.close();
+    bool departOk = departCsv.close();
+    return startOk && departOk;
+}
+
+/**
+ * @brief Writes decoded time matrices as Gantt chart rows, in the format read by
+ * results/gen-gantt.r
+ * 
+ * @param data Decoded times file
+ * @param filePath Path to the output *.csv file
+ * @return Returns true on success. Otherwise false.
+ */
+bool TimesFile::exportGantt(const TimesData& data, const char* filePath)
+{
+    util::CsvWriter csv;
+    if (!csv.open(filePath)) return false;
+
+    writeGanttHeader(csv);
+
+    size_t item = 1;
+    for (size_t m = 0; m < data.machines; m++)
+        item = writeGanttRows(csv, item, m, &data.startTimes[m * data.jobs], &data.departTimes[m * data.jobs], data.jobs);
+
+    return csv.close();
+}
+
+/**
+ * @brief Writes the Gantt chart column labels
+ * 
+ * @param csv Writer to append the header row to
+ */
+void TimesFile::writeGanttHeader(util::CsvWriter& csv)
+{
+    csv.field("Item").field("Machine").field("Job").field("Start").field("End").endRow();
+}
+
+/**
+ * @brief Writes the Gantt chart rows for one machine. Jobs are labeled by
+ * their position in the job sequence, matching the existing gantt files.
+ * 
+ * @param csv Writer to append the rows to
+ * @param firstItem Item number of the first row
+ * @param machine Zero based machine index
+ * @param startTimes Start times of the machine row
+ * @param departTimes Departure times of the machine row
+ * @param jobs Number of jobs in the row
+ * @return Returns the item number following the last written row
+ */
+size_t TimesFile::writeGanttRows(util::CsvWriter& csv, size_t firstItem, size_t machine, const int* startTimes, const int* departTimes, size_t jobs)
+{
+    const std::string machineLabel = std::string("Machine ") + std::to_string(machine + 1);
+    char jobLabel[32];
+
+    for (size_t j = 0; j < jobs; j++)
+    {
+        std::snprintf(jobLabel, sizeof(jobLabel), "Job %zu", j + 1);
+        csv.field(firstItem + j).field(machineLabel).field(jobLabel).field(startTimes[j]).field(departTimes[j]).endRow();
+    }
+
+    return firstItem + jobs;
+}
+
+/**
+ * @brief Delta and varint encodes a job sequence and its time matrices
+ */
+void TimesFile::encode(std::string& out, const int* jobSeq, const int* const* startTimes, const int* const* departTimes, size_t machines, size_t jobs)
+{
+    out.clear();
+    out.reserve(jobs * (2 * machines + 1) * 2);
+
+    for (size_t j = 0; j < jobs; j++)
+        putVarint(out, jobSeq[j]);
+
+    for (size_t m = 0; m < machines; m++)
+    {
+        int64_t prev = 0;
+        for (size_t j = 0; j < jobs; j++)
+        {
+            putVarint(out, static_cast<int64_t>(startTimes[m][j]) - prev);
+            prev = startTimes[m][j];
+        }
+
+        for (size_t j = 0; j < jobs; j++)
+            putVarint(out, static_cast<int64_t>(departTimes[m][j]) - startTimes[m][j]);
+    }
+}
+
+/**
+ * @brief Decodes a block produced by encode(). The machine and job counts
+ * must already be set in data. Throws std::runtime_error on error.
+ */
+void TimesFile::decode(const char* p, const char* end, TimesData& data)
+{
+    const size_t cells = data.machines * data.jobs;
+
+    data.jobSequence.resize(data.jobs);
+    data.startTimes.resize(cells);
+    data.departTimes.resize(cells);
+
+    for (size_t j = 0; j < data.jobs; j++)
+        data.jobSequence[j] = getVarint(p, end);
+
+    for (size_t m = 0; m < data.machines; m++)
+    {
+        int* start = &data.startTimes[m * data.jobs];
+        int* depart = &data.departTimes[m * data.jobs];
+
+        int prev = 0;
+        for (size_t j = 0; j < data.jobs; j++)
+        {
+            prev += getVarint(p, end);
+            start[j] = prev;
+        }
+
+        for (size_t j = 0; j < data.jobs; j++)
+            depart[j] = start[j] + getVarint(p, end);
+    }
+
+    if (p != end)
+        throw std::runtime_error("Error: Times file has trailing data.");
+}
+
+// =========================
+// End of timesfile.cpp
+// =========================
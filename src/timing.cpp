@@ -0,0 +1,141 @@
+/**
+ * @file timing.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the PhaseClock class and the scoped phase timers.
+ * @version 0.1
+ * @date 2019-06-01
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <ctime>
+#include "timing.h"
+
+#if defined(_WIN32)
+    #include <windows.h>
+#endif
+
+using namespace util;
+
+/**
+ * @brief Returns the CPU time used by the calling thread so far
+ * 
+ * @return Returns the thread CPU time in milliseconds
+ */
+double util::threadCpuTimeMs()
+{
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        return 0.0;
+
+    // FILETIME counts 100 nanosecond intervals
+    const unsigned long long k = (static_cast<unsigned long long>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    const unsigned long long u = (static_cast<unsigned long long>(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return static_cast<double>(k + u) / 10000.0;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return 0.0;
+
+    return static_cast<double>(ts.tv_sec) * 1000.0 + static_cast<double>(ts.tv_nsec) / 1000000.0;
+#else
+    // Process CPU time is the closest available measure
+    return static_cast<double>(std::clock()) * 1000.0 / CLOCKS_PER_SEC;
+#endif
+}
+
+/**
+ * @brief Construct a new PhaseClock object and start it
+ */
+PhaseClock::PhaseClock()
+{
+    restart();
+}
+
+/**
+ * @brief Restarts the clock from zero
+ */
+void PhaseClock::restart()
+{
+    wallStart = std::chrono::steady_clock::now();
+    cpuStart = threadCpuTimeMs();
+}
+
+/**
+ * @brief Returns the wall clock and thread CPU time elapsed since the clock was started
+ * 
+ * @return Returns the elapsed times in milliseconds
+ */
+PhaseTime PhaseClock::elapsed() const
+{
+    using namespace std::chrono;
+
+    PhaseTime t;
+    t.wallMs = static_cast<double>(duration_cast<nanoseconds>(steady_clock::now() - wallStart).count()) / 1000000.0;
+    t.cpuMs = threadCpuTimeMs() - cpuStart;
+    return t;
+}
+
+// ============================================================
+
+/**
+ * @brief Returns the display name of a timed phase
+ */
+const char* util::phaseName(TimedPhase phase)
+{
+    static const char* names[PHASE_COUNT] = { "load", "sort", "insertion", "evaluation", "output" };
+    return phase < PHASE_COUNT ? names[phase] : "unknown";
+}
+
+/**
+ * @brief Adds the totals of another PhaseTotals to these totals
+ * 
+ * @param o Totals to add
+ */
+void PhaseTotals::add(const PhaseTotals& o)
+{
+    for (int i = 0; i < PHASE_COUNT; i++)
+    {
+        nanos[i] += o.nanos[i];
+        count[i] += o.count[i];
+        allocs[i] += o.allocs[i];
+        allocBytes[i] += o.allocBytes[i];
+    }
+}
+
+/**
+ * @brief Returns the time added to these totals after an earlier snapshot of them
+ * 
+ * @param earlier Snapshot of the same totals, taken earlier
+ * @return Returns the difference between the totals
+ */
+PhaseTotals PhaseTotals::since(const PhaseTotals& earlier) const
+{
+    PhaseTotals diff;
+    for (int i = 0; i < PHASE_COUNT; i++)
+    {
+        diff.nanos[i] = nanos[i] - earlier.nanos[i];
+        diff.count[i] = count[i] - earlier.count[i];
+        diff.allocs[i] = allocs[i] - earlier.allocs[i];
+        diff.allocBytes[i] = allocBytes[i] - earlier.allocBytes[i];
+    }
+
+    return diff;
+}
+
+/**
+ * @brief Returns the phase totals of the calling thread, which accumulate
+ * for the lifetime of the thread. Take a copy before and after a unit of
+ * work and use PhaseTotals::since() to get the totals of that work.
+ */
+PhaseTotals& util::threadPhaseTotals()
+{
+    static thread_local PhaseTotals totals;
+    return totals;
+}
+
+// =========================
+// End of timing.cpp
+// =========================
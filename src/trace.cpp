@@ -0,0 +1,227 @@
+/**
+ * @file trace.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the Tracer class.
+ * @version 0.1
+ * @date 2019-06-04
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <cstdio>
+#include "trace.h"
+#include "jsonl.h"
+
+using namespace util;
+
+/**
+ * @brief Construct a new Tracer object, with tracing disabled
+ */
+Tracer::Tracer()
+    : enabled(false), origin(std::chrono::steady_clock::now()), eventsPerThread(0), stepSampling(1), generation(0)
+{
+}
+
+/**
+ * @brief Returns the process-wide tracer used by the FSHOP_TRACE macros
+ */
+Tracer& Tracer::global()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+/**
+ * @brief Discards the events of any previous session and starts recording.
+ * Must not be called while other threads are recording.
+ * 
+ * @param _eventsPerThread Capacity of each thread's ring buffer
+ * @param _stepSampling Trace every Nth step of repeated operations, see sampleStep()
+ */
+void Tracer::start(size_t _eventsPerThread, unsigned int _stepSampling)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    buffers.clear();
+    eventsPerThread = _eventsPerThread > 0 ? _eventsPerThread : 1;
+    stepSampling = _stepSampling > 0 ? _stepSampling : 1;
+    generation++;
+    origin = std::chrono::steady_clock::now();
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Stops recording. Recorded events are kept until the next start().
+ */
+void Tracer::stop()
+{
+    enabled.store(false, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the time since tracing started, in nanoseconds
+ */
+int64_t Tracer::now() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+/**
+ * @brief Returns the ring buffer of the calling thread, creating and
+ * registering it the first time the thread records in this session
+ */
+Tracer::ThreadBuffer& Tracer::threadBuffer()
+{
+    static thread_local std::shared_ptr<ThreadBuffer> buffer;
+    static thread_local const Tracer* owner = nullptr;
+
+    if (buffer == nullptr || owner != this || buffer->generation != generation)
+    {
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.resize(eventsPerThread);
+        buffer->generation = generation;
+        owner = this;
+
+        std::lock_guard<std::mutex> guard(lock);
+        buffer->tid = static_cast<int>(buffers.size()) + 1;
+        buffers.push_back(buffer);
+    }
+
+    return *buffer;
+}
+
+/**
+ * @brief Records an event on the calling thread, overwriting its oldest
+ * event if its buffer is full
+ * 
+ * @param e Event to record
+ */
+void Tracer::record(const TraceEvent& e)
+{
+    if (!isEnabled()) return;
+
+    ThreadBuffer& b = threadBuffer();
+    b.events[b.recorded % b.events.size()] = e;
+    b.recorded++;
+}
+
+/**
+ * @brief Names the calling thread in the trace, as the role followed by its
+ * trace thread id. Threads keep the first name they are given.
+ * 
+ * @param role Role of the thread, such as "solver"
+ */
+void Tracer::nameThread(const char* role)
+{
+    if (!isEnabled()) return;
+
+    ThreadBuffer& b = threadBuffer();
+    if (b.name.empty())
+        b.name = std::string(role) + " " + std::to_string(b.tid);
+}
+
+/**
+ * @brief Returns the number of events overwritten because a thread's buffer was full
+ */
+uint64_t Tracer::getDropped()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    uint64_t dropped = 0;
+    for (auto& b : buffers)
+    {
+        if (b->recorded > b->events.size())
+            dropped += b->recorded - b->events.size();
+    }
+
+    return dropped;
+}
+
+/**
+ * @brief Writes the recorded events as a Chrome Trace Event file, which can be
+ * opened in chrome://tracing or ui.perfetto.dev. Every thread is one track.
+ * Must not be called while other threads are recording.
+ * 
+ * @param filePath Path of the trace file
+ * @param policy When the file is synced to disk
+ * @return Returns true if the file was written. Otherwise false.
+ */
+bool Tracer::writeChromeTrace(const char* filePath, FsyncPolicy policy)
+{
+    const uint64_t dropped = getDropped();
+
+    CsvWriter out;
+    if (!out.open(filePath, policy))
+        return false;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    static const char header[] = "{\"traceEvents\":[\n";
+    out.raw(header, sizeof(header) - 1);
+
+    bool first = true;
+    auto writeEvent = [&](JsonRecord& rec)
+    {
+        if (!first) out.raw(",\n", 2);
+        const std::string& text = rec.str();
+        out.raw(text.data(), text.size());
+        first = false;
+    };
+
+    for (auto& b : buffers)
+    {
+        // Thread name metadata
+        JsonRecord meta;
+        meta.field("name", "thread_name").field("ph", "M").field("pid", 1).field("tid", b->tid);
+        meta.beginObject("args").field("name", b->name.empty() ? "thread " + std::to_string(b->tid) : b->name).endObject();
+        writeEvent(meta);
+
+        // Oldest event first
+        const uint64_t capacity = b->events.size();
+        const uint64_t count = b->recorded < capacity ? b->recorded : capacity;
+
+        for (uint64_t i = b->recorded - count; i < b->recorded; i++)
+        {
+            const TraceEvent& e = b->events[i % capacity];
+
+            // Written directly rather than with JsonRecord, to keep nanosecond
+            // precision in the microsecond timestamps of long traces. Event and
+            // argument names are literals that need no escaping.
+            char text[384];
+            int len = std::snprintf(text, sizeof(text),
+                "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld.%03lld,\"dur\":%lld.%03lld,\"pid\":1,\"tid\":%d",
+                e.name, e.category,
+                static_cast<long long>(e.beginNs / 1000), static_cast<long long>(e.beginNs % 1000),
+                static_cast<long long>(e.durationNs / 1000), static_cast<long long>(e.durationNs % 1000), b->tid);
+
+            if (e.argNames[0] != nullptr && len > 0 && static_cast<size_t>(len) < sizeof(text))
+            {
+                len += std::snprintf(text + len, sizeof(text) - len, ",\"args\":{\"%s\":%lld", e.argNames[0], static_cast<long long>(e.args[0]));
+                if (e.argNames[1] != nullptr && static_cast<size_t>(len) < sizeof(text))
+                    len += std::snprintf(text + len, sizeof(text) - len, ",\"%s\":%lld", e.argNames[1], static_cast<long long>(e.args[1]));
+                if (static_cast<size_t>(len) < sizeof(text))
+                    len += std::snprintf(text + len, sizeof(text) - len, "}");
+            }
+
+            if (len <= 0 || static_cast<size_t>(len) + 1 >= sizeof(text))
+                continue;
+
+            text[len++] = '}';
+            if (!first) out.raw(",\n", 2);
+            out.raw(text, static_cast<size_t>(len));
+            first = false;
+        }
+    }
+
+    JsonRecord footer;
+    footer.field("droppedEvents", static_cast<unsigned long long>(dropped));
+    const std::string tail = "\n],\"displayTimeUnit\":\"ms\",\"otherData\":" + footer.str() + "}\n";
+    out.raw(tail.data(), tail.size());
+
+    return out.close();
+}
+
+// =========================
+// End of trace.cpp
+// =========================
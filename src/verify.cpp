@@ -0,0 +1,235 @@
+/**
+ * @file verify.cpp
+ * @author Andrew Dunn (Andrew.Dunn@cwu.edu)
+ * @brief Implementation file for the ResultsVerifier class.
+ * @version 0.1
+ * @date 2019-06-03
+ * 
+ * @copyright Copyright (c) 2019
+ * 
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <vector>
+#include "verify.h"
+#include "stringutils.h"
+
+using namespace cs471;
+
+/**
+ * @brief Splits one line of a results file into its comma separated fields
+ */
+static std::vector<std::string> splitFields(const std::string& line)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+    size_t comma;
+
+    while ((comma = line.find(',', start)) != std::string::npos)
+    {
+        fields.push_back(util::s_trim_copy(line.substr(start, comma - start)));
+        start = comma + 1;
+    }
+
+    fields.push_back(util::s_trim_copy(line.substr(start)));
+    return fields;
+}
+
+/**
+ * @brief Converts a quality check name from a parameter file into a QualityCheck.
+ * Accepted names are "exact" and "noworse".
+ * 
+ * @param name Name of the check
+ * @param out Out reference that receives the check
+ * @return Returns true if the name is known. Otherwise false.
+ */
+bool cs471::parseQualityCheck(const std::string& name, QualityCheck& out)
+{
+    if (name == "exact")
+        out = QUALITY_EXACT;
+    else if (name == "noworse")
+        out = QUALITY_NO_WORSE;
+    else
+        return false;
+
+    return true;
+}
+
+/**
+ * @brief Construct a new ResultsVerifier object
+ * 
+ * @param _name Name of the variant being verified, used in messages
+ * @param _params Verification thresholds
+ * @param _out Stream that receives the report
+ */
+ResultsVerifier::ResultsVerifier(const std::string& _name, const VerifyParams& _params, std::ostream& _out)
+    : name(_name), params(_params), out(_out)
+{
+}
+
+/**
+ * @brief Reads the data set number, cMax, TFT and execution time of every row of
+ * a results *.csv file. Columns are found by their header labels, so files written
+ * by older versions with fewer columns can be read too.
+ * 
+ * @param filePath Path to the results file
+ * @return Returns the results by data set number
+ */
+ResultSet ResultsVerifier::readCsv(const std::string& filePath)
+{
+    std::ifstream file(filePath);
+    if (!file.is_open())
+        throw std::runtime_error("Error: Unable to open results file: " + filePath);
+
+    std::string line;
+    if (!std::getline(file, line))
+        throw std::runtime_error("Error: Results file is empty: " + filePath);
+
+    // Locate the needed columns by label
+    std::vector<std::string> labels = splitFields(line);
+    int setCol = -1, cmaxCol = -1, tftCol = -1, timeCol = -1;
+
+    for (size_t c = 0; c < labels.size(); c++)
+    {
+        if (labels[c] == "Data Set") setCol = static_cast<int>(c);
+        else if (labels[c] == "cMax") cmaxCol = static_cast<int>(c);
+        else if (labels[c] == "TFT") tftCol = static_cast<int>(c);
+        else if (labels[c] == "Execution Time (ms)") timeCol = static_cast<int>(c);
+    }
+
+    if (setCol < 0 || cmaxCol < 0 || tftCol < 0 || timeCol < 0)
+        throw std::runtime_error("Error: Results file is missing a Data Set, cMax, TFT or Execution Time column: " + filePath);
+
+    const size_t needCols = static_cast<size_t>(std::max(std::max(setCol, cmaxCol), std::max(tftCol, timeCol))) + 1;
+
+    ResultSet results;
+    while (std::getline(file, line))
+    {
+        if (util::s_trim_copy(line).empty()) continue;
+
+        std::vector<std::string> fields = splitFields(line);
+        if (fields.size() < needCols)
+            throw std::runtime_error("Error: Malformed row in results file: " + filePath);
+
+        try
+        {
+            ResultRecord rec;
+            rec.cmax = std::stoi(fields[cmaxCol]);
+            rec.tft = std::stoi(fields[tftCol]);
+            rec.timeMs = std::stod(fields[timeCol]);
+            results[std::stoi(fields[setCol])] = rec;
+        }
+        catch (const std::logic_error&)
+        {
+            throw std::runtime_error("Error: Malformed row in results file: " + filePath);
+        }
+    }
+
+    return results;
+}
+
+/**
+ * @brief Checks the solution quality of every golden data set. A golden data set
+ * without results in the run is reported and counts as a failure.
+ * 
+ * @param golden Golden results
+ * @param actual Results of the run being verified
+ * @return Returns true if no data set is missing or worse than allowed
+ */
+bool ResultsVerifier::checkQuality(const ResultSet& golden, const ResultSet& actual)
+{
+    size_t failed = 0;
+    size_t missing = 0;
+
+    for (auto& g : golden)
+    {
+        auto a = actual.find(g.first);
+        if (a == actual.end())
+        {
+            missing++;
+            out << name << ": data set " << g.first << " has golden results but is missing from the run" << std::endl;
+            continue;
+        }
+
+        const ResultRecord& gr = g.second;
+        const ResultRecord& ar = a->second;
+
+        bool ok;
+        if (params.quality == QUALITY_EXACT)
+            ok = ar.cmax == gr.cmax && ar.tft == gr.tft;
+        else
+            ok = ar.cmax <= gr.cmax * (1.0 + params.qualityTolerance);
+
+        if (!ok)
+        {
+            failed++;
+            out << name << ": data set " << g.first << " quality regressed: cMax " << ar.cmax << " TFT " << ar.tft
+                << ", golden cMax " << gr.cmax << " TFT " << gr.tft << std::endl;
+        }
+    }
+
+    if (golden.empty())
+    {
+        out << name << ": the golden results have no data sets" << std::endl;
+        return false;
+    }
+
+    out << name << ": quality " << (failed || missing ? "FAILED" : "OK") << " (" << golden.size() - failed - missing << " of "
+        << golden.size() << " data sets " << (params.quality == QUALITY_EXACT ? "match" : "no worse") << ", " << missing
+        << " missing)" << std::endl;
+
+    return failed == 0 && missing == 0;
+}
+
+/**
+ * @brief Checks the total execution time of the set, and of every data set that
+ * is slow enough to be measured on its own, against a baseline
+ * 
+ * @param baseline Baseline results
+ * @param actual Results of the run being verified
+ * @return Returns true if neither a checked data set nor the total is slower than allowed
+ */
+bool ResultsVerifier::checkTime(const ResultSet& baseline, const ResultSet& actual)
+{
+    size_t failed = 0;
+    size_t checked = 0;
+    double baseTotal = 0.0;
+    double actualTotal = 0.0;
+
+    for (auto& b : baseline)
+    {
+        auto a = actual.find(b.first);
+        if (a == actual.end()) continue;
+
+        baseTotal += b.second.timeMs;
+        actualTotal += a->second.timeMs;
+
+        // Data sets under the floor only count toward the total
+        if (b.second.timeMs < params.timeFloorMs) continue;
+
+        checked++;
+        if (a->second.timeMs > b.second.timeMs * (1.0 + params.instanceTimeTolerance))
+        {
+            failed++;
+            out << name << ": data set " << b.first << " slowed down: " << a->second.timeMs
+                << " ms, baseline " << b.second.timeMs << " ms" << std::endl;
+        }
+    }
+
+    const bool totalOk = actualTotal <= baseTotal * (1.0 + params.timeTolerance);
+    const double change = baseTotal > 0.0 ? (actualTotal / baseTotal - 1.0) * 100.0 : 0.0;
+
+    out << name << ": time " << (failed == 0 && totalOk ? "OK" : "FAILED") << " (total " << std::fixed << std::setprecision(2)
+        << actualTotal << " ms, baseline " << baseTotal << " ms, " << std::showpos << change << std::noshowpos << "%, "
+        << failed << " of " << checked << " data sets over " << params.timeFloorMs << " ms slower than allowed)"
+        << std::defaultfloat << std::setprecision(6) << std::endl;
+
+    return failed == 0 && totalOk;
+}
+
+// =========================
+// End of verify.cpp
+// =========================
@@ -5,4 +5,5 @@ cmake -DCMAKE_BUILD_TYPE=Debug ../
 make
 mkdir -p debug
 mv ./cs471-proj5.out debug/cs471-proj5.out
+mv ./flowshop-bench debug/flowshop-bench
 echo Program binary moved to build/debug
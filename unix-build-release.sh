@@ -5,4 +5,5 @@ cmake -DCMAKE_BUILD_TYPE=Release ../
 make
 mkdir -p release
 mv ./cs471-proj5.out release/cs471-proj5.out
+mv ./flowshop-bench release/flowshop-bench
 echo Program binary moved to build/release
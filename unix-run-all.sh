@@ -1,18 +1,8 @@
 set -e
+mkdir -p results/fss-times
+mkdir -p results/fsb-times
+mkdir -p results/fsnw-times
 
-echo "----------------------"
-
-./unix-run-fss.sh
-
-echo "----------------------"
-
-./unix-run-fsb.sh
-
-echo "----------------------"
-
-./unix-run-fsnw.sh
-
-echo "----------------------"
-
-echo "All scripts ran."
+./build/release/cs471-proj5.out params/all.ini
 
+echo "All tests finished."
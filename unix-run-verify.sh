@@ -0,0 +1,7 @@
+set -e
+mkdir -p results/golden
+
+./build/release/cs471-proj5.out verify params/verify.ini
+./build/release/cs471-proj5.out verify params/verify-memory.ini
+
+echo "Verification finished."
@@ -4,5 +4,6 @@ cmake -DCMAKE_BUILD_TYPE=Release -G "MinGW Makefiles" ..
 mingw32-make
 mkdir release
 move /y cs471-proj5.out.exe release\cs471-proj5.out.exe
+move /y flowshop-bench.exe release\flowshop-bench.exe
 cd ..\
 cmd /k
@@ -3,8 +3,6 @@ mkdir results\fss-times
 mkdir results\fsb-times
 mkdir results\fsnw-times
 
-build\release\cs471-proj5.out.exe params\fss.ini
-build\release\cs471-proj5.out.exe params\fsb.ini
-build\release\cs471-proj5.out.exe params\fsnw.ini
+build\release\cs471-proj5.out.exe params\all.ini
 
 cmd /k